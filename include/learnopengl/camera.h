@@ -5,8 +5,18 @@
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
 #include <vector>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEARNOPENGL_CAMERA_SSE
+#endif
+
 
 // Defines several possible options for camera movement. Used as abstraction to stay away from window-system specific input methods
 enum CameraMovement
@@ -26,6 +36,80 @@ const float SENSITIVITY = 0.1f;
 const float ZOOM = 45.0f;
 
 
+// How a perspective projection maps view depth.
+enum class ProjectionDepth
+{
+    Standard,           // glm::perspective: the near plane maps to -1, the far plane to 1
+    ReverseInfinite     // the near plane maps to 1 and infinity to 0, see enableReverseDepth()
+};
+
+
+// The reverse-Z projection with no far plane: depth is zNear / distance, so float depth keeps about the same
+// relative precision at every distance instead of spending nearly all of it close to the near plane.
+inline glm::mat4 reverseInfinitePerspective(float fovy, float aspect, float zNear)
+{
+    float f = 1.0f / std::tan(fovy * 0.5f);
+    glm::mat4 projection(0.0f);
+    projection[0][0] = f / aspect;
+    projection[1][1] = f;
+    projection[2][3] = -1.0f;
+    projection[3][2] = zNear;
+
+    return projection;
+}
+
+
+// Sets up the current context for ProjectionDepth::ReverseInfinite: [0, 1] clip depth, so the projection's depth is
+// not remapped (which would cancel the precision gain), a GL_GREATER depth test and a clear depth of 0. The depth
+// buffer should be GL_DEPTH_COMPONENT32F. Returns false, changing nothing, without GL_ARB_clip_control.
+inline bool enableReverseDepth()
+{
+    if (!GLAD_GL_ARB_clip_control)
+    {
+        return false;
+    }
+
+    glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
+    glDepthFunc(GL_GREATER);
+    glClearDepth(0.0);
+
+    return true;
+}
+
+
+// The last projection a camera built, returned again while its parameters stay the same.
+class ProjectionCache
+{
+public:
+    const glm::mat4 & get(float fovyDegrees, float aspect, float zNear, float zFar, ProjectionDepth depth)
+    {
+        if (fovyDegrees != cachedFovy || aspect != cachedAspect || zNear != cachedNear || zFar != cachedFar ||
+            depth != cachedDepth)
+        {
+            cachedFovy = fovyDegrees;
+            cachedAspect = aspect;
+            cachedNear = zNear;
+            cachedFar = zFar;
+            cachedDepth = depth;
+
+            projection = depth == ProjectionDepth::ReverseInfinite ?
+                         reverseInfinitePerspective(glm::radians(fovyDegrees), aspect, zNear) :
+                         glm::perspective(glm::radians(fovyDegrees), aspect, zNear, zFar);
+        }
+
+        return projection;
+    }
+
+private:
+    glm::mat4 projection {1.0f};
+    float cachedFovy {0.0f};
+    float cachedAspect {0.0f};
+    float cachedNear {0.0f};
+    float cachedFar {0.0f};
+    ProjectionDepth cachedDepth {ProjectionDepth::Standard};
+};
+
+
 class Camera
 {
 public:
@@ -70,6 +154,32 @@ public:
         return glm::lookAt(Position, Position + Front, Up);
     }
 
+    // the projection for Zoom and Depth, cached; zFar is unused with ProjectionDepth::ReverseInfinite
+    const glm::mat4 & GetProjectionMatrix(float aspect, float zNear = 0.1f, float zFar = 100.0f) const
+    {
+        return projectionCache.get(Zoom, aspect, zNear, zFar, Depth);
+    }
+
+    // pixels covered by one world unit at distance 1, for a viewport of the given height and the current Zoom;
+    // a world-space size s at distance d covers s * GetProjectionScale(height) / d pixels
+    float GetProjectionScale(float viewportHeight) const
+    {
+        return viewportHeight / (2.0f * std::tan(glm::radians(Zoom) * 0.5f));
+    }
+
+    // the camera a fraction alpha of the way from previous to current, for rendering between two fixed updates
+    static Camera Interpolate(const Camera & previous, const Camera & current, float alpha)
+    {
+        Camera camera = current;
+        camera.Position = glm::mix(previous.Position, current.Position, alpha);
+        camera.Yaw = previous.Yaw + (current.Yaw - previous.Yaw) * alpha;
+        camera.Pitch = previous.Pitch + (current.Pitch - previous.Pitch) * alpha;
+        camera.Zoom = previous.Zoom + (current.Zoom - previous.Zoom) * alpha;
+        camera.updateCameraVectors();
+
+        return camera;
+    }
+
     // Processes input received from any keyboard-like input system.
     // Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
     void ProcessKeyboard(CameraMovement direction, float deltaTime)
@@ -158,6 +268,7 @@ public:
     float MovementSpeed;
     float MouseSensitivity;
     float Zoom;
+    ProjectionDepth Depth {ProjectionDepth::Standard};
 
 
 private:
@@ -175,6 +286,495 @@ private:
         Right = glm::normalize(glm::cross(Front, WorldUp));
         Up = glm::normalize(glm::cross(Right, Front));
     }
+
+private:
+    mutable ProjectionCache projectionCache;
+};
+
+
+// A camera oriented by a quaternion instead of Euler angles, with the interface of Camera.
+//
+// Mouse input turns the orientation by small rotations, so there is no gimbal lock and the basis vectors come from
+// rotating the axes, without trigonometry. With constrainPitch the camera yaws about WorldUp and keeps the horizon
+// level, like Camera; without it, it turns about its own axes and can loop freely.
+class QuaternionCamera
+{
+public:
+    QuaternionCamera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f),
+                     glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
+                     float yaw = YAW,
+                     float pitch = PITCH) :
+            Position(position),
+            WorldUp(up),
+            MovementSpeed(SPEED),
+            MouseSensitivity(SENSITIVITY),
+            Zoom(ZOOM)
+    {
+        // Camera's yaw of -90 looks down -z, which is the identity orientation here
+        Orientation = glm::angleAxis(glm::radians(-(yaw - YAW)), up) *
+                      glm::angleAxis(glm::radians(pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+        updateCameraVectors();
+    }
+
+    glm::mat4 GetViewMatrix() const
+    {
+        glm::mat4 view = glm::mat4_cast(glm::conjugate(Orientation));
+        view[3] = glm::vec4(-glm::dot(Right, Position), -glm::dot(Up, Position), glm::dot(Front, Position), 1.0f);
+
+        return view;
+    }
+
+    const glm::mat4 & GetProjectionMatrix(float aspect, float zNear = 0.1f, float zFar = 100.0f) const
+    {
+        return projectionCache.get(Zoom, aspect, zNear, zFar, Depth);
+    }
+
+    float GetProjectionScale(float viewportHeight) const
+    {
+        return viewportHeight / (2.0f * std::tan(glm::radians(Zoom) * 0.5f));
+    }
+
+    void ProcessKeyboard(CameraMovement direction, float deltaTime)
+    {
+        float velocity = MovementSpeed * deltaTime;
+
+        switch (direction)
+        {
+        case FORWARD:
+            Position += Front * velocity;
+            break;
+        case BACKWARD:
+            Position -= Front * velocity;
+            break;
+        case LEFT:
+            Position -= Right * velocity;
+            break;
+        case RIGHT:
+            Position += Right * velocity;
+            break;
+        default:
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Invalid direction!"
+                      << std::nounitbuf << std::endl;
+            std::abort();
+        }
+    }
+
+    void ProcessMouseMovement(float xoffset, float yoffset, GLboolean constrainPitch = true)
+    {
+        float yaw = glm::radians(-xoffset * MouseSensitivity);
+        float pitch = glm::radians(yoffset * MouseSensitivity);
+
+        if (constrainPitch)
+        {
+            // stop 1 degree short of straight up or down, as Camera does
+            float limit = glm::radians(89.0f);
+            float current = std::asin(glm::clamp(glm::dot(Front, WorldUp), -1.0f, 1.0f));
+            pitch = glm::clamp(current + pitch, -limit, limit) - current;
+
+            Orientation = glm::angleAxis(yaw, WorldUp) * Orientation *
+                          glm::angleAxis(pitch, glm::vec3(1.0f, 0.0f, 0.0f));
+        }
+        else
+        {
+            Orientation = Orientation * glm::angleAxis(yaw, glm::vec3(0.0f, 1.0f, 0.0f)) *
+                          glm::angleAxis(pitch, glm::vec3(1.0f, 0.0f, 0.0f));
+        }
+
+        updateCameraVectors();
+    }
+
+    // turns the camera about its line of sight; only meaningful without constrainPitch
+    void ProcessRoll(float degrees)
+    {
+        Orientation = Orientation * glm::angleAxis(glm::radians(degrees), glm::vec3(0.0f, 0.0f, -1.0f));
+        updateCameraVectors();
+    }
+
+    void ProcessMouseScroll(float yoffset)
+    {
+        Zoom = glm::clamp(Zoom - yoffset, 1.0f, 45.0f);
+    }
+
+public:
+    glm::vec3 Position;
+    glm::quat Orientation;      // rotates camera space (looking down -z, y up) to world space
+    glm::vec3 Front;
+    glm::vec3 Up;
+    glm::vec3 Right;
+    glm::vec3 WorldUp;
+
+    float MovementSpeed;
+    float MouseSensitivity;
+    float Zoom;
+    ProjectionDepth Depth {ProjectionDepth::Standard};
+
+private:
+    void updateCameraVectors()
+    {
+        // renormalized on every change, so rounding cannot accumulate into a scale
+        Orientation = glm::normalize(Orientation);
+        Front = Orientation * glm::vec3(0.0f, 0.0f, -1.0f);
+        Up = Orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+        Right = Orientation * glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+
+private:
+    mutable ProjectionCache projectionCache;
+};
+
+
+// The six planes of a view-projection's clip volume, pointing inwards.
+struct Frustum
+{
+    Frustum() = default;
+
+    explicit Frustum(const glm::mat4 & viewProjection)
+    {
+        // rows of the matrix (glm is column-major), combined as by Gribb and Hartmann
+        glm::vec4 rows[4];
+
+        for (int i = 0; i != 4; ++i)
+        {
+            rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+        }
+
+        for (int i = 0; i != 3; ++i)
+        {
+            planes[2 * i] = rows[3] + rows[i];
+            planes[2 * i + 1] = rows[3] - rows[i];
+        }
+
+        for (glm::vec4 & plane : planes)
+        {
+            plane *= 1.0f / glm::length(glm::vec3(plane));
+        }
+    }
+
+    bool intersectsSphere(const glm::vec3 & center, float radius) const
+    {
+        for (const glm::vec4 & plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    glm::vec4 planes[6];
+};
+
+
+// View, projection and frustum of many cameras at once: shadow cascades, split-screen views, reflection probes.
+//
+// Poses and projections are stored as structure-of-arrays. update() derives every view, view-projection and frustum
+// four cameras at a time with SSE, one register per matrix entry, and transposes only to store the results. A
+// projection is kept as the eight coefficients that perspective and orthographic matrices can have, so both kinds
+// share the same batch:
+//
+//     | sx  0   0   tx |
+//     | 0   sy  0   ty |
+//     | 0   0   a   b  |
+//     | 0   0   c   d  |
+class CameraSet
+{
+public:
+    using Index = std::uint32_t;
+
+public:
+    // a camera at the pose, with a 45 degree perspective until another projection is set
+    Index add(const glm::vec3 & position, const glm::quat & orientation)
+    {
+        auto index = static_cast<Index>(positions.size());
+
+        positions.push_back(position);
+        orientations.push_back(glm::normalize(orientation));
+        projections.emplace_back(1.0f);
+        coefficients.emplace_back();
+        views.emplace_back(1.0f);
+        viewProjections.emplace_back(1.0f);
+        frustums.emplace_back();
+
+        setPerspective(index, glm::radians(ZOOM), 1.0f, 0.1f, 100.0f);
+
+        return index;
+    }
+
+    Index add(const QuaternionCamera & camera, float aspect, float zNear, float zFar)
+    {
+        Index index = add(camera.Position, camera.Orientation);
+
+        if (camera.Depth == ProjectionDepth::ReverseInfinite)
+        {
+            setReverseInfinitePerspective(index, glm::radians(camera.Zoom), aspect, zNear);
+        }
+        else
+        {
+            setPerspective(index, glm::radians(camera.Zoom), aspect, zNear, zFar);
+        }
+
+        return index;
+    }
+
+    void setPose(Index index, const glm::vec3 & position, const glm::quat & orientation)
+    {
+        positions[index] = position;
+        orientations[index] = glm::normalize(orientation);
+    }
+
+    // as glm::perspective
+    void setPerspective(Index index, float fovy, float aspect, float zNear, float zFar)
+    {
+        float f = 1.0f / std::tan(fovy * 0.5f);
+        setProjection(index, {f / aspect, f, 0.0f, 0.0f, -(zFar + zNear) / (zFar - zNear),
+                              -2.0f * zFar * zNear / (zFar - zNear), -1.0f, 0.0f});
+    }
+
+    // as reverseInfinitePerspective; the frustum's far plane then lies behind the camera and never culls
+    void setReverseInfinitePerspective(Index index, float fovy, float aspect, float zNear)
+    {
+        float f = 1.0f / std::tan(fovy * 0.5f);
+        setProjection(index, {f / aspect, f, 0.0f, 0.0f, 0.0f, zNear, -1.0f, 0.0f});
+    }
+
+    // as glm::ortho
+    void setOrthographic(Index index, float left, float right, float bottom, float top, float zNear, float zFar)
+    {
+        setProjection(index, {2.0f / (right - left), 2.0f / (top - bottom),
+                              -(right + left) / (right - left), -(top + bottom) / (top - bottom),
+                              -2.0f / (zFar - zNear), -(zFar + zNear) / (zFar - zNear), 0.0f, 1.0f});
+    }
+
+    // recomputes the views, view-projections and frustums of all cameras
+    void update()
+    {
+        std::size_t i = 0;
+
+#ifdef LEARNOPENGL_CAMERA_SSE
+        for (; i + 4 <= positions.size(); i += 4)
+        {
+            updateBatch(i);
+        }
+#endif
+
+        for (; i != positions.size(); ++i)
+        {
+            updateOne(i);
+        }
+    }
+
+    std::size_t size() const
+    {
+        return positions.size();
+    }
+
+    const glm::mat4 & getView(Index index) const
+    {
+        return views[index];
+    }
+
+    const glm::mat4 & getProjection(Index index) const
+    {
+        return projections[index];
+    }
+
+    const glm::mat4 & getViewProjection(Index index) const
+    {
+        return viewProjections[index];
+    }
+
+    const Frustum & getFrustum(Index index) const
+    {
+        return frustums[index];
+    }
+
+private:
+    struct Coefficients
+    {
+        float sx, sy, tx, ty, a, b, c, d;
+    };
+
+    void setProjection(Index index, const Coefficients & p)
+    {
+        coefficients[index] = p;
+
+        glm::mat4 & projection = projections[index];
+        projection = glm::mat4(0.0f);
+        projection[0][0] = p.sx;
+        projection[1][1] = p.sy;
+        projection[3][0] = p.tx;
+        projection[3][1] = p.ty;
+        projection[2][2] = p.a;
+        projection[3][2] = p.b;
+        projection[2][3] = p.c;
+        projection[3][3] = p.d;
+    }
+
+    void updateOne(std::size_t i)
+    {
+        glm::mat4 & view = views[i];
+        view = glm::mat4_cast(glm::conjugate(orientations[i]));
+        view[3] = glm::vec4(glm::vec3(view * glm::vec4(-positions[i], 0.0f)), 1.0f);
+
+        // P * V, using the zeros of P
+        const Coefficients & p = coefficients[i];
+        glm::vec4 row0(view[0][0], view[1][0], view[2][0], view[3][0]);
+        glm::vec4 row1(view[0][1], view[1][1], view[2][1], view[3][1]);
+        glm::vec4 row2(view[0][2], view[1][2], view[2][2], view[3][2]);
+        glm::vec4 rows[4] = {p.sx * row0 + glm::vec4(0.0f, 0.0f, 0.0f, p.tx),
+                             p.sy * row1 + glm::vec4(0.0f, 0.0f, 0.0f, p.ty),
+                             p.a * row2 + glm::vec4(0.0f, 0.0f, 0.0f, p.b),
+                             p.c * row2 + glm::vec4(0.0f, 0.0f, 0.0f, p.d)};
+
+        for (int c = 0; c != 4; ++c)
+        {
+            viewProjections[i][c] = glm::vec4(rows[0][c], rows[1][c], rows[2][c], rows[3][c]);
+        }
+
+        frustums[i] = Frustum(viewProjections[i]);
+    }
+
+#ifdef LEARNOPENGL_CAMERA_SSE
+    void updateBatch(std::size_t first)
+    {
+        const glm::quat * q = &orientations[first];
+        const glm::vec3 * position = &positions[first];
+        const Coefficients * p = &coefficients[first];
+
+        __m128 qx = _mm_setr_ps(q[0].x, q[1].x, q[2].x, q[3].x);
+        __m128 qy = _mm_setr_ps(q[0].y, q[1].y, q[2].y, q[3].y);
+        __m128 qz = _mm_setr_ps(q[0].z, q[1].z, q[2].z, q[3].z);
+        __m128 qw = _mm_setr_ps(q[0].w, q[1].w, q[2].w, q[3].w);
+        __m128 px = _mm_setr_ps(position[0].x, position[1].x, position[2].x, position[3].x);
+        __m128 py = _mm_setr_ps(position[0].y, position[1].y, position[2].y, position[3].y);
+        __m128 pz = _mm_setr_ps(position[0].z, position[1].z, position[2].z, position[3].z);
+
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 xx = _mm_mul_ps(qx, qx);
+        __m128 yy = _mm_mul_ps(qy, qy);
+        __m128 zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy);
+        __m128 xz = _mm_mul_ps(qx, qz);
+        __m128 yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx);
+        __m128 wy = _mm_mul_ps(qw, qy);
+        __m128 wz = _mm_mul_ps(qw, qz);
+
+        // the rows of the view's rotation are the camera's right, up and back axes
+        __m128 v[3][4];
+        v[0][0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+        v[0][1] = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+        v[0][2] = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+        v[1][0] = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+        v[1][1] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+        v[1][2] = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+        v[2][0] = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+        v[2][1] = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+        v[2][2] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+        for (int r = 0; r != 3; ++r)
+        {
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v[r][0], px), _mm_mul_ps(v[r][1], py)),
+                                    _mm_mul_ps(v[r][2], pz));
+            v[r][3] = _mm_sub_ps(_mm_setzero_ps(), dot);
+        }
+
+        __m128 sx = _mm_setr_ps(p[0].sx, p[1].sx, p[2].sx, p[3].sx);
+        __m128 sy = _mm_setr_ps(p[0].sy, p[1].sy, p[2].sy, p[3].sy);
+        __m128 tx = _mm_setr_ps(p[0].tx, p[1].tx, p[2].tx, p[3].tx);
+        __m128 ty = _mm_setr_ps(p[0].ty, p[1].ty, p[2].ty, p[3].ty);
+        __m128 a = _mm_setr_ps(p[0].a, p[1].a, p[2].a, p[3].a);
+        __m128 b = _mm_setr_ps(p[0].b, p[1].b, p[2].b, p[3].b);
+        __m128 c = _mm_setr_ps(p[0].c, p[1].c, p[2].c, p[3].c);
+        __m128 d = _mm_setr_ps(p[0].d, p[1].d, p[2].d, p[3].d);
+
+        // rows of P * V; the fourth row of V is (0, 0, 0, 1)
+        __m128 vp[4][4];
+
+        for (int k = 0; k != 4; ++k)
+        {
+            vp[0][k] = _mm_mul_ps(sx, v[0][k]);
+            vp[1][k] = _mm_mul_ps(sy, v[1][k]);
+            vp[2][k] = _mm_mul_ps(a, v[2][k]);
+            vp[3][k] = _mm_mul_ps(c, v[2][k]);
+        }
+
+        vp[0][3] = _mm_add_ps(vp[0][3], tx);
+        vp[1][3] = _mm_add_ps(vp[1][3], ty);
+        vp[2][3] = _mm_add_ps(vp[2][3], b);
+        vp[3][3] = _mm_add_ps(vp[3][3], d);
+
+        // planes r3 + r0, r3 - r0, r3 + r1, ... as in Frustum, normalized by their xyz length
+        __m128 planes[6][4];
+
+        for (int i = 0; i != 3; ++i)
+        {
+            for (int k = 0; k != 4; ++k)
+            {
+                planes[2 * i][k] = _mm_add_ps(vp[3][k], vp[i][k]);
+                planes[2 * i + 1][k] = _mm_sub_ps(vp[3][k], vp[i][k]);
+            }
+        }
+
+        for (auto & plane : planes)
+        {
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], plane[0]),
+                                                              _mm_mul_ps(plane[1], plane[1])),
+                                                   _mm_mul_ps(plane[2], plane[2])));
+            __m128 scale = _mm_div_ps(one, length);
+
+            for (__m128 & component : plane)
+            {
+                component = _mm_mul_ps(component, scale);
+            }
+
+            _MM_TRANSPOSE4_PS(plane[0], plane[1], plane[2], plane[3]);
+        }
+
+        // from one register per entry to one per column (view, view-projection) or plane
+        __m128 zero = _mm_setzero_ps();
+        __m128 w[4] = {zero, zero, zero, one};
+
+        for (int k = 0; k != 4; ++k)
+        {
+            _MM_TRANSPOSE4_PS(v[0][k], v[1][k], v[2][k], w[k]);
+            _MM_TRANSPOSE4_PS(vp[0][k], vp[1][k], vp[2][k], vp[3][k]);
+        }
+
+        // after the transposes, [n][k] is column k of camera n
+        for (int n = 0; n != 4; ++n)
+        {
+            float * view = &views[first + n][0][0];
+            float * viewProjection = &viewProjections[first + n][0][0];
+
+            for (int k = 0; k != 4; ++k)
+            {
+                _mm_storeu_ps(view + 4 * k, n == 3 ? w[k] : v[n][k]);
+                _mm_storeu_ps(viewProjection + 4 * k, vp[n][k]);
+            }
+
+            for (int i = 0; i != 6; ++i)
+            {
+                _mm_storeu_ps(&frustums[first + n].planes[i][0], planes[i][n]);
+            }
+        }
+    }
+#endif
+
+private:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> orientations;
+    std::vector<Coefficients> coefficients;
+
+    std::vector<glm::mat4> projections;
+    std::vector<glm::mat4> views;
+    std::vector<glm::mat4> viewProjections;
+    std::vector<Frustum> frustums;
 };
 
 #endif // LEARNOPENGL_CAMERA_H
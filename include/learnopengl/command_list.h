@@ -0,0 +1,223 @@
+#ifndef LEARNOPENGL_COMMAND_LIST_H
+#define LEARNOPENGL_COMMAND_LIST_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+// One recorded draw. Plain data, so lists are cheap to build on any thread and to copy between threads.
+struct DrawCommand
+{
+    std::uint64_t key;             // see CommandList::makeKey
+    unsigned int program;
+    unsigned int vertexArray;
+    unsigned int textures[2];      // bound to units 0 and 1, 0 for none
+    int modelLocation;             // uniform receiving model, -1 for none
+    const glm::mat4 * model;       // points into per-frame storage that outlives execute(), e.g. a FrameArena
+    int first;
+    int count;
+    int instanceCount;             // 1 issues a plain glDrawArrays
+};
+
+
+// A list of draws that is recorded first, sorted by state key and then executed in one pass.
+//
+// Recording touches no GL state, so several threads can each record their own list and merge them with append().
+// Sorting groups draws by program, then texture set, then vertex array, and finally front to back, so execute()
+// binds each distinct state once per group instead of once per draw.
+class CommandList
+{
+public:
+    struct Stats
+    {
+        std::size_t draws;
+        std::size_t programChanges;
+        std::size_t textureChanges;
+        std::size_t vertexArrayChanges;
+    };
+
+    // called by execute() after a program is bound, e.g. to set the per-frame uniforms of that program
+    using ProgramCallback = std::function<void(unsigned int program)>;
+
+public:
+    // 64-bit key, most significant first: program (12 bits), texture set (16), vertex array (12), depth (24).
+    // Object names are folded into their fields; a collision only costs sorting quality, never correctness.
+    // depth is the view depth normalized to [0, 1]; smaller is drawn first.
+    static std::uint64_t makeKey(unsigned int program, const unsigned int (& textures)[2], unsigned int vertexArray,
+                                 float depth)
+    {
+        std::uint64_t textureSet = (textures[0] * 0x9E37u + textures[1]) & 0xFFFFu;
+        auto depthBits = static_cast<std::uint64_t>(std::min(std::max(depth, 0.0f), 1.0f) * 0xFFFFFF);
+
+        return (static_cast<std::uint64_t>(program & 0xFFFu) << 52) |
+               (textureSet << 36) |
+               (static_cast<std::uint64_t>(vertexArray & 0xFFFu) << 24) |
+               depthBits;
+    }
+
+    void clear()
+    {
+        commands.clear();
+        order.clear();
+        sorted = false;
+    }
+
+    void reserve(std::size_t count)
+    {
+        commands.reserve(count);
+    }
+
+    std::size_t size() const
+    {
+        return commands.size();
+    }
+
+    // records a draw; the key is derived from its state unless given explicitly afterwards
+    DrawCommand & draw(unsigned int program, unsigned int vertexArray, unsigned int texture0, unsigned int texture1,
+                       int modelLocation, const glm::mat4 * model, int first, int count, float depth,
+                       int instanceCount = 1)
+    {
+        DrawCommand command {};
+        command.program = program;
+        command.vertexArray = vertexArray;
+        command.textures[0] = texture0;
+        command.textures[1] = texture1;
+        command.modelLocation = modelLocation;
+        command.model = model;
+        command.first = first;
+        command.count = count;
+        command.instanceCount = instanceCount;
+        command.key = makeKey(program, command.textures, vertexArray, depth);
+        commands.push_back(command);
+        sorted = false;
+
+        return commands.back();
+    }
+
+    // merges another (e.g. per-thread) list into this one
+    void append(const CommandList & other)
+    {
+        commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+        sorted = false;
+    }
+
+    // stable LSD radix sort of the keys, 8 bits per pass; passes over bytes that are equal in every key are skipped
+    void sort()
+    {
+        std::size_t n = commands.size();
+        order.resize(n);
+        scratch.resize(n);
+
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            order[i] = static_cast<std::uint32_t>(i);
+        }
+
+        for (int shift = 0; shift != 64; shift += 8)
+        {
+            std::size_t histogram[257] = {};
+
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                ++histogram[((commands[i].key >> shift) & 0xFF) + 1];
+            }
+
+            if (std::find(histogram + 1, histogram + 257, n) != histogram + 257)
+            {
+                continue;
+            }
+
+            for (int digit = 0; digit != 256; ++digit)
+            {
+                histogram[digit + 1] += histogram[digit];
+            }
+
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                std::uint32_t index = order[i];
+                scratch[histogram[(commands[index].key >> shift) & 0xFF]++] = index;
+            }
+
+            order.swap(scratch);
+        }
+
+        sorted = true;
+    }
+
+    // issues every draw in sorted order (recording order if sort() was not called since the last change)
+    Stats execute(const ProgramCallback & onProgram = nullptr) const
+    {
+        Stats stats {commands.size(), 0, 0, 0};
+        unsigned int program = 0;
+        unsigned int vertexArray = 0;
+        unsigned int textures[2] = {0, 0};
+        bool first = true;
+
+        for (std::size_t i = 0; i != commands.size(); ++i)
+        {
+            const DrawCommand & command = commands[sorted ? order[i] : i];
+
+            if (first || command.program != program)
+            {
+                program = command.program;
+                glUseProgram(program);
+                ++stats.programChanges;
+
+                if (onProgram)
+                {
+                    onProgram(program);
+                }
+            }
+
+            for (int unit = 0; unit != 2; ++unit)
+            {
+                if (first || command.textures[unit] != textures[unit])
+                {
+                    textures[unit] = command.textures[unit];
+                    glActiveTexture(GL_TEXTURE0 + unit);
+                    glBindTexture(GL_TEXTURE_2D, textures[unit]);
+                    ++stats.textureChanges;
+                }
+            }
+
+            if (first || command.vertexArray != vertexArray)
+            {
+                vertexArray = command.vertexArray;
+                glBindVertexArray(vertexArray);
+                ++stats.vertexArrayChanges;
+            }
+
+            first = false;
+
+            if (command.modelLocation >= 0 && command.model)
+            {
+                glUniformMatrix4fv(command.modelLocation, 1, GL_FALSE, &(*command.model)[0][0]);
+            }
+
+            if (command.instanceCount == 1)
+            {
+                glDrawArrays(GL_TRIANGLES, command.first, command.count);
+            }
+            else
+            {
+                glDrawArraysInstanced(GL_TRIANGLES, command.first, command.count, command.instanceCount);
+            }
+        }
+
+        return stats;
+    }
+
+private:
+    std::vector<DrawCommand> commands;
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint32_t> scratch;
+    bool sorted {false};
+};
+
+#endif // LEARNOPENGL_COMMAND_LIST_H
@@ -0,0 +1,289 @@
+#ifndef LEARNOPENGL_DYNAMIC_RESOLUTION_H
+#define LEARNOPENGL_DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "learnopengl/shader.h"
+
+
+enum class UpscaleFilter
+{
+    Bilinear,
+    Sharpen
+};
+
+
+struct DynamicResolutionSettings
+{
+    double targetTime {1.0 / 60.0 * 0.9};  // seconds of GPU time the scene pass may take
+    float minScale {0.5f};                 // per axis
+    float maxScale {1.0f};
+    float scaleStep {0.05f};               // scales are multiples of this
+    double lowerBand {0.85};               // share of the target below which the scale may grow
+    int riseFrames {30};
+    double smoothing {0.2};                // weight of a new measurement in the moving average
+    GLenum depthFormat {GL_DEPTH24_STENCIL8};  // GL_DEPTH_COMPONENT32F for reverse-Z
+};
+
+
+// Renders the scene at a resolution that follows the GPU time of the scene pass, then upscales it to the window.
+//
+// The target is allocated once at the full window size and the scene is drawn into its lower left part, so a scale
+// change is a viewport change and never a reallocation. GPU time comes from GL_TIME_ELAPSED queries in a small ring,
+// read only once available, a few frames late. Each result is divided by the pixel count it was rendered at, so the
+// delay does not matter: the cost per pixel predicts the scale that meets the target.
+//
+// Hysteresis keeps the scale from oscillating: it drops as soon as the smoothed time is over the target, but rises
+// only after the time has stayed below lowerBand of the target for riseFrames in a row, and it moves in steps.
+class DynamicResolution
+{
+public:
+    explicit DynamicResolution(const DynamicResolutionSettings & settings = DynamicResolutionSettings()) :
+            settings(settings),
+            scale(settings.maxScale)
+    {
+        glGenFramebuffers(1, &framebuffer);
+        glGenTextures(1, &colorTexture);
+        glGenRenderbuffers(1, &depthRenderbuffer);
+        glGenQueries(kQueryCount, queries);
+        glGenVertexArrays(1, &emptyVertexArray);
+    }
+
+    DynamicResolution(const DynamicResolution &) = delete;
+
+    DynamicResolution & operator=(const DynamicResolution &) = delete;
+
+    ~DynamicResolution()
+    {
+        glDeleteVertexArrays(1, &emptyVertexArray);
+        glDeleteQueries(kQueryCount, queries);
+        glDeleteRenderbuffers(1, &depthRenderbuffer);
+        glDeleteTextures(1, &colorTexture);
+        glDeleteFramebuffers(1, &framebuffer);
+    }
+
+    // binds the scaled target and starts timing; the scene is drawn after this
+    void beginFrame(int windowWidth, int windowHeight)
+    {
+        if (windowWidth != width || windowHeight != height)
+        {
+            allocate(windowWidth, windowHeight);
+        }
+
+        collectQueries();
+
+        renderWidth = std::max(1, static_cast<int>(std::lround(width * scale)));
+        renderHeight = std::max(1, static_cast<int>(std::lround(height * scale)));
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, renderWidth, renderHeight);
+
+        // a query still pending in this slot is skipped rather than waited for
+        timing = !pending[nextQuery];
+
+        if (timing)
+        {
+            glBeginQuery(GL_TIME_ELAPSED, queries[nextQuery]);
+        }
+    }
+
+    // stops timing and draws the scene onto the default framebuffer with the given filter; uniforms are those that
+    // shader_reflect generates for upscaleShader, built from src/shader/10_upscale_*.glsl
+    template <typename UpscaleUniforms>
+    void endFrame(Shader & upscaleShader, const UpscaleUniforms & uniforms, UpscaleFilter filter,
+                  float sharpness = 0.5f)
+    {
+        if (timing)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+            pending[nextQuery] = true;
+            queryPixels[nextQuery] = static_cast<double>(renderWidth) * renderHeight;
+            nextQuery = (nextQuery + 1) % kQueryCount;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        upscaleShader.use();
+        uniforms.source.set({0});
+        uniforms.uvScale.set(glm::vec2(static_cast<float>(renderWidth) / width,
+                                       static_cast<float>(renderHeight) / height));
+        uniforms.sharpness.set(filter == UpscaleFilter::Sharpen ? sharpness : 0.0f);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glBindVertexArray(emptyVertexArray);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+
+        if (depthTest)
+        {
+            glEnable(GL_DEPTH_TEST);
+        }
+    }
+
+    // per axis, of the frame being drawn
+    float getScale() const
+    {
+        return scale;
+    }
+
+    // smoothed GPU time of the scene pass in seconds, 0 before the first result
+    double getGpuTime() const
+    {
+        return gpuTime;
+    }
+
+    // parses "bilinear" or "sharpen"; anything else leaves filter unchanged and returns false
+    static bool parseFilter(const char * name, UpscaleFilter & filter)
+    {
+        if (!std::strcmp(name, "bilinear"))
+        {
+            filter = UpscaleFilter::Bilinear;
+        }
+        else if (!std::strcmp(name, "sharpen"))
+        {
+            filter = UpscaleFilter::Sharpen;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    void allocate(int windowWidth, int windowHeight)
+    {
+        width = std::max(1, windowWidth);
+        height = std::max(1, windowHeight);
+
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, settings.depthFormat, width, height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        bool stencil = settings.depthFormat == GL_DEPTH24_STENCIL8 || settings.depthFormat == GL_DEPTH32F_STENCIL8;
+        GLenum depthAttachment = stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, depthAttachment, GL_RENDERBUFFER, depthRenderbuffer);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Dynamic resolution framebuffer is incomplete!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    // reads the finished queries, oldest first, and adjusts the scale
+    void collectQueries()
+    {
+        for (int n = 0; n != kQueryCount; ++n)
+        {
+            int slot = (nextQuery + n) % kQueryCount;
+
+            if (!pending[slot])
+            {
+                continue;
+            }
+
+            GLint available = 0;
+            glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (!available)
+            {
+                break;
+            }
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            pending[slot] = false;
+
+            // the time this frame would have taken at full scale
+            double fullScaleTime = static_cast<double>(nanoseconds) * 1e-9 *
+                                   (static_cast<double>(width) * height) / queryPixels[slot];
+            fullTime = fullTime > 0.0 ? fullTime + settings.smoothing * (fullScaleTime - fullTime) : fullScaleTime;
+            gpuTime = fullTime * scale * scale;
+
+            adjustScale();
+        }
+    }
+
+    void adjustScale()
+    {
+        // GPU time grows with the pixel count, so with the square of the per-axis scale
+        double fit = std::sqrt(settings.targetTime / fullTime);
+        auto quantized = static_cast<float>(std::floor(fit / settings.scaleStep) * settings.scaleStep);
+        quantized = std::min(settings.maxScale, std::max(settings.minScale, quantized));
+
+        if (gpuTime > settings.targetTime && quantized < scale)
+        {
+            scale = quantized;
+            belowBand = 0;
+        }
+        else if (gpuTime < settings.targetTime * settings.lowerBand && scale < settings.maxScale)
+        {
+            if (++belowBand >= settings.riseFrames)
+            {
+                // one step at a time, and never beyond what the measurement supports
+                scale = std::min(quantized, scale + settings.scaleStep);
+                belowBand = 0;
+            }
+        }
+        else
+        {
+            belowBand = 0;
+        }
+    }
+
+private:
+    static constexpr int kQueryCount = 4;
+
+    DynamicResolutionSettings settings;
+    float scale;
+
+    unsigned int framebuffer {0};
+    unsigned int colorTexture {0};
+    unsigned int depthRenderbuffer {0};
+    unsigned int emptyVertexArray {0};
+
+    int width {0};
+    int height {0};
+    int renderWidth {0};
+    int renderHeight {0};
+
+    unsigned int queries[kQueryCount] {};
+    bool pending[kQueryCount] {};
+    double queryPixels[kQueryCount] {};
+    int nextQuery {0};
+    bool timing {false};
+
+    double fullTime {0.0};
+    double gpuTime {0.0};
+    int belowBand {0};
+};
+
+#endif // LEARNOPENGL_DYNAMIC_RESOLUTION_H
@@ -0,0 +1,494 @@
+#ifndef LEARNOPENGL_ECS_H
+#define LEARNOPENGL_ECS_H
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "learnopengl/job_system.h"
+
+
+// components of scene objects
+
+struct Transform
+{
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+    glm::mat4 world;        // written by a transform system from the fields above
+};
+
+struct Mesh
+{
+    unsigned int vertexArray;
+    int first;
+    int count;
+};
+
+struct Material
+{
+    unsigned int program;
+    unsigned int textures[2];
+};
+
+// bounding sphere in local space
+struct Bounds
+{
+    glm::vec3 center;
+    float radius;
+};
+
+
+// An entity: an index into the world's records and the generation that index had when the entity was created,
+// so a handle to a destroyed entity is detected even after its index was reused.
+struct Entity
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+};
+
+
+// An archetype-based entity-component system.
+//
+// Entities with exactly the same set of component types share an archetype. An archetype stores its entities in
+// fixed-size chunks, and inside a chunk every component type is one contiguous array (structure-of-arrays), so a
+// query over some components streams through memory and never touches components it did not ask for. Entities
+// stay packed: destroying one moves the last entity of its archetype into the hole.
+// Components must be trivially copyable (they are moved with memcpy); at most 64 component types exist.
+class World
+{
+public:
+    static constexpr std::size_t kChunkSize = 16 * 1024;
+
+public:
+    World() = default;
+
+    World(const World &) = delete;
+
+    World & operator=(const World &) = delete;
+
+    // creates an entity with the given components
+    template <typename ... Ts>
+    Entity create(const Ts & ... components)
+    {
+        Entity entity = allocateEntity();
+        Archetype & archetype = getArchetype(maskOf<Ts ...>());
+        place(entity, archetype);
+
+        int expand[] = {0, (new (componentAt<Ts>(entity)) Ts(components), 0) ...};
+        (void) expand;
+
+        return entity;
+    }
+
+    void destroy(Entity entity)
+    {
+        if (!isAlive(entity))
+        {
+            return;
+        }
+
+        Record & record = records[entity.index];
+        removeRow(*record.archetype, record.row);
+        record.archetype = nullptr;
+        ++record.generation;
+        freeIndices.push_back(entity.index);
+        --entityCount;
+    }
+
+    bool isAlive(Entity entity) const
+    {
+        return entity.index < records.size() &&
+               records[entity.index].generation == entity.generation &&
+               records[entity.index].archetype;
+    }
+
+    template <typename T>
+    bool has(Entity entity) const
+    {
+        return isAlive(entity) && (records[entity.index].archetype->mask & bitOf<T>());
+    }
+
+    // the entity must have the component
+    template <typename T>
+    T & get(Entity entity)
+    {
+        if (!has<T>(entity))
+        {
+            fail(isAlive(entity) ? "get() of a component the entity does not have" : "get() on a dead entity");
+        }
+
+        return *componentAt<T>(entity);
+    }
+
+    // adds (or overwrites) a component, moving the entity to the archetype that has it
+    template <typename T>
+    void add(Entity entity, const T & component)
+    {
+        if (!isAlive(entity))
+        {
+            fail("add() on a dead entity");
+        }
+
+        Record & record = records[entity.index];
+
+        if (!(record.archetype->mask & bitOf<T>()))
+        {
+            move(entity, record.archetype->mask | bitOf<T>());
+        }
+
+        new (componentAt<T>(entity)) T(component);
+    }
+
+    template <typename T>
+    void remove(Entity entity)
+    {
+        if (!isAlive(entity))
+        {
+            fail("remove() on a dead entity");
+        }
+
+        Record & record = records[entity.index];
+
+        if (record.archetype->mask & bitOf<T>())
+        {
+            move(entity, record.archetype->mask & ~bitOf<T>());
+        }
+    }
+
+    std::size_t size() const
+    {
+        return entityCount;
+    }
+
+    std::size_t getArchetypeCount() const
+    {
+        return archetypes.size();
+    }
+
+    // calls f(entity, components & ...) for every entity that has all of Ts
+    template <typename ... Ts, typename Function>
+    void each(Function && f)
+    {
+        eachChunk<Ts ...>([&f](std::size_t count, const Entity * entities, Ts * ... components)
+                          {
+                              for (std::size_t i = 0; i != count; ++i)
+                              {
+                                  f(entities[i], components[i] ...);
+                              }
+                          });
+    }
+
+    // calls f(count, entities, Ts * ...) once per chunk with the component arrays of its count entities;
+    // the form to write tight (vectorizable) loops in
+    template <typename ... Ts, typename Function>
+    void eachChunk(Function && f)
+    {
+        ComponentMask mask = maskOf<Ts ...>();
+
+        for (const std::unique_ptr<Archetype> & archetype : archetypes)
+        {
+            if ((archetype->mask & mask) != mask)
+            {
+                continue;
+            }
+
+            for (std::size_t chunk = 0; chunk * archetype->capacity < archetype->count; ++chunk)
+            {
+                callChunk<Ts ...>(*archetype, chunk, f);
+            }
+        }
+    }
+
+    // eachChunk with the chunks spread over the job system; f runs concurrently on different chunks
+    template <typename ... Ts, typename Function>
+    void parallelEachChunk(JobSystem & jobSystem, const Function & f)
+    {
+        ComponentMask mask = maskOf<Ts ...>();
+
+        // per call, so calls from other threads or from inside f do not share it
+        std::vector<std::pair<Archetype *, std::size_t>> chunkList;
+
+        for (const std::unique_ptr<Archetype> & archetype : archetypes)
+        {
+            if ((archetype->mask & mask) != mask)
+            {
+                continue;
+            }
+
+            for (std::size_t chunk = 0; chunk * archetype->capacity < archetype->count; ++chunk)
+            {
+                chunkList.emplace_back(archetype.get(), chunk);
+            }
+        }
+
+        jobSystem.parallelFor(0, chunkList.size(), 1, [this, &f, &chunkList](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i != last; ++i)
+            {
+                callChunk<Ts ...>(*chunkList[i].first, chunkList[i].second, f);
+            }
+        });
+    }
+
+private:
+    using ComponentMask = std::uint64_t;
+
+    struct ComponentInfo
+    {
+        std::size_t size;
+        std::size_t alignment;
+    };
+
+    struct Chunk
+    {
+        alignas(64) unsigned char data[kChunkSize];
+    };
+
+    struct Archetype
+    {
+        ComponentMask mask;
+        std::vector<unsigned int> components;   // ids of the component types, ascending
+        std::size_t offsets[64];                // array offset inside a chunk, per component id
+        std::size_t capacity;                   // entities per chunk
+        std::size_t count;
+        std::vector<std::unique_ptr<Chunk>> chunks;
+    };
+
+    struct Record
+    {
+        Archetype * archetype;
+        std::size_t row;
+        std::uint32_t generation;
+    };
+
+    [[noreturn]] static void fail(const char * message)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << message
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    static std::vector<ComponentInfo> & componentInfos()
+    {
+        static std::vector<ComponentInfo> infos;
+        return infos;
+    }
+
+    template <typename T>
+    static unsigned int componentId()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "components must be trivially copyable");
+
+        static const unsigned int id = []
+        {
+            std::vector<ComponentInfo> & infos = componentInfos();
+
+            if (infos.size() == 64)
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "More than 64 component types!"
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+
+            infos.push_back({sizeof(T), alignof(T)});
+
+            return static_cast<unsigned int>(infos.size() - 1);
+        }();
+
+        return id;
+    }
+
+    template <typename T>
+    static ComponentMask bitOf()
+    {
+        return ComponentMask(1) << componentId<T>();
+    }
+
+    template <typename ... Ts>
+    static ComponentMask maskOf()
+    {
+        ComponentMask mask = 0;
+        int expand[] = {0, (mask |= bitOf<Ts>(), 0) ...};
+        (void) expand;
+
+        return mask;
+    }
+
+    template <typename T>
+    T * componentAt(Entity entity)
+    {
+        const Record & record = records[entity.index];
+        return static_cast<T *>(componentAt(*record.archetype, record.row, componentId<T>()));
+    }
+
+    static void * componentAt(Archetype & archetype, std::size_t row, unsigned int component)
+    {
+        Chunk & chunk = *archetype.chunks[row / archetype.capacity];
+        return chunk.data + archetype.offsets[component] +
+               (row % archetype.capacity) * componentInfos()[component].size;
+    }
+
+    static Entity * entityAt(Archetype & archetype, std::size_t row)
+    {
+        Chunk & chunk = *archetype.chunks[row / archetype.capacity];
+        return reinterpret_cast<Entity *>(chunk.data) + row % archetype.capacity;
+    }
+
+    template <typename ... Ts, typename Function>
+    static void callChunk(Archetype & archetype, std::size_t chunk, Function & f)
+    {
+        std::size_t count = std::min(archetype.capacity, archetype.count - chunk * archetype.capacity);
+        unsigned char * data = archetype.chunks[chunk]->data;
+
+        f(count, reinterpret_cast<const Entity *>(data),
+          reinterpret_cast<Ts *>(data + archetype.offsets[componentId<Ts>()]) ...);
+    }
+
+    Entity allocateEntity()
+    {
+        ++entityCount;
+
+        if (!freeIndices.empty())
+        {
+            std::uint32_t index = freeIndices.back();
+            freeIndices.pop_back();
+
+            return {index, records[index].generation};
+        }
+
+        records.push_back({nullptr, 0, 0});
+
+        return {static_cast<std::uint32_t>(records.size() - 1), 0};
+    }
+
+    Archetype & getArchetype(ComponentMask mask)
+    {
+        auto it = archetypeByMask.find(mask);
+
+        if (it != archetypeByMask.end())
+        {
+            return *it->second;
+        }
+
+        auto archetype = std::make_unique<Archetype>();
+        archetype->mask = mask;
+        archetype->count = 0;
+
+        std::size_t rowSize = sizeof(Entity);
+        std::size_t padding = 0;
+
+        for (unsigned int id = 0; id != 64; ++id)
+        {
+            if (mask & (ComponentMask(1) << id))
+            {
+                archetype->components.push_back(id);
+                rowSize += componentInfos()[id].size;
+                padding += componentInfos()[id].alignment;
+            }
+        }
+
+        // entity handles first, then one array per component, each aligned for its type
+        archetype->capacity = (kChunkSize - padding) / rowSize;
+        std::size_t offset = archetype->capacity * sizeof(Entity);
+
+        for (unsigned int id : archetype->components)
+        {
+            const ComponentInfo & info = componentInfos()[id];
+            offset = (offset + info.alignment - 1) / info.alignment * info.alignment;
+            archetype->offsets[id] = offset;
+            offset += archetype->capacity * info.size;
+        }
+
+        Archetype & result = *archetype;
+        archetypeByMask.emplace(mask, archetype.get());
+        archetypes.push_back(std::move(archetype));
+
+        return result;
+    }
+
+    // appends the entity to the archetype and points its record there
+    void place(Entity entity, Archetype & archetype)
+    {
+        std::size_t row = archetype.count++;
+
+        if (row / archetype.capacity == archetype.chunks.size())
+        {
+            archetype.chunks.push_back(std::make_unique<Chunk>());
+        }
+
+        *entityAt(archetype, row) = entity;
+        records[entity.index].archetype = &archetype;
+        records[entity.index].row = row;
+    }
+
+    // fills the hole at row with the archetype's last entity
+    void removeRow(Archetype & archetype, std::size_t row)
+    {
+        std::size_t last = --archetype.count;
+
+        if (row == last)
+        {
+            return;
+        }
+
+        for (unsigned int id : archetype.components)
+        {
+            std::memcpy(componentAt(archetype, row, id), componentAt(archetype, last, id), componentInfos()[id].size);
+        }
+
+        Entity moved = *entityAt(archetype, last);
+        *entityAt(archetype, row) = moved;
+        records[moved.index].row = row;
+    }
+
+    // moves the entity to the archetype of mask, keeping the components both archetypes have
+    void move(Entity entity, ComponentMask mask)
+    {
+        Record & record = records[entity.index];
+        Archetype & from = *record.archetype;
+        std::size_t fromRow = record.row;
+        Archetype & to = getArchetype(mask);
+
+        place(entity, to);
+
+        for (unsigned int id : from.components)
+        {
+            if (to.mask & (ComponentMask(1) << id))
+            {
+                std::memcpy(componentAt(to, record.row, id), componentAt(from, fromRow, id),
+                            componentInfos()[id].size);
+            }
+        }
+
+        removeRow(from, fromRow);
+    }
+
+private:
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<ComponentMask, Archetype *> archetypeByMask;
+
+    std::vector<Record> records;
+    std::vector<std::uint32_t> freeIndices;
+    std::size_t entityCount {0};
+};
+
+#endif // LEARNOPENGL_ECS_H
@@ -0,0 +1,82 @@
+#ifndef LEARNOPENGL_FIXED_TIMESTEP_H
+#define LEARNOPENGL_FIXED_TIMESTEP_H
+
+#include <algorithm>
+#include <cmath>
+
+
+// Decouples simulation from the frame rate: frame times go into an accumulator, which is spent in updates of a fixed
+// step, and the remainder tells the renderer how far to interpolate between the last two simulation states.
+//
+// A frame that would need more than maxUpdates updates (a hitch, a breakpoint, a machine too slow for the rate) runs
+// only maxUpdates and discards the rest of its time. Otherwise the slow frame would schedule more updates, making the
+// next frame slower still: the spiral of death. The simulation then runs slower than real time instead.
+class FixedTimestep
+{
+public:
+    explicit FixedTimestep(double updateRate = 120.0, int maxUpdates = 8) :
+            step(1.0 / std::max(updateRate, 1.0)),
+            maxUpdates(std::max(1, maxUpdates))
+    {
+    }
+
+    // adds a frame's duration and returns the number of updates to run for it
+    int advance(double frameTime)
+    {
+        accumulator += std::max(0.0, frameTime);
+
+        double due = std::floor(accumulator / step);
+
+        if (due > maxUpdates)
+        {
+            droppedTime += (due - maxUpdates) * step;
+            accumulator -= (due - maxUpdates) * step;
+            due = maxUpdates;
+            ++clampedFrames;
+        }
+
+        accumulator = std::max(0.0, accumulator - due * step);
+        updates += static_cast<unsigned long long>(due);
+
+        return static_cast<int>(due);
+    }
+
+    // seconds per update
+    double getStep() const
+    {
+        return step;
+    }
+
+    // how far rendering is past the last update, in [0, 1): 0 shows the previous state, 1 would show the latest
+    float getAlpha() const
+    {
+        return static_cast<float>(std::min(accumulator / step, 1.0));
+    }
+
+    unsigned long long getUpdates() const
+    {
+        return updates;
+    }
+
+    // frames that hit maxUpdates, and the simulation time they gave up
+    unsigned long long getClampedFrames() const
+    {
+        return clampedFrames;
+    }
+
+    double getDroppedTime() const
+    {
+        return droppedTime;
+    }
+
+private:
+    double step;
+    int maxUpdates;
+
+    double accumulator {0.0};
+    unsigned long long updates {0};
+    unsigned long long clampedFrames {0};
+    double droppedTime {0.0};
+};
+
+#endif // LEARNOPENGL_FIXED_TIMESTEP_H
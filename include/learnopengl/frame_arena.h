@@ -0,0 +1,345 @@
+#ifndef LEARNOPENGL_FRAME_ARENA_H
+#define LEARNOPENGL_FRAME_ARENA_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+
+// Counts heap allocations made through the global operator new, per thread and in total.
+//
+// The per-thread count can only be read by its own thread. A thread that binds itself to one of kSlotCount slots
+// also counts into that slot, which any thread can read; e.g. bind each job thread to its thread index from the
+// JobSystem's thread start callback and sum the slots to include the workers.
+//
+// The counting operators are only compiled into the one translation unit that defines
+// LEARNOPENGL_COUNT_ALLOCATIONS before including this header (every sample is a single translation unit).
+// Without them the counters stay at zero.
+class AllocationCounter
+{
+public:
+    static std::size_t getThreadCount()
+    {
+        return threadCount();
+    }
+
+    static std::size_t getTotalCount()
+    {
+        return totalCount().load(std::memory_order_relaxed);
+    }
+
+    static constexpr unsigned int kSlotCount = 64;
+
+    // counts the calling thread's allocations from now on into slot as well
+    static void bindSlot(unsigned int slot)
+    {
+        threadSlot() = slot < kSlotCount ? &slots()[slot] : nullptr;
+    }
+
+    static std::size_t getSlotCount(unsigned int slot)
+    {
+        return slot < kSlotCount ? slots()[slot].load(std::memory_order_relaxed) : 0;
+    }
+
+    // the sum of slots [first, last)
+    static std::size_t getSlotCount(unsigned int first, unsigned int last)
+    {
+        std::size_t count = 0;
+
+        for (unsigned int slot = first; slot < last && slot < kSlotCount; ++slot)
+        {
+            count += getSlotCount(slot);
+        }
+
+        return count;
+    }
+
+    static void record()
+    {
+        ++threadCount();
+        totalCount().fetch_add(1, std::memory_order_relaxed);
+
+        if (std::atomic<std::size_t> * slot = threadSlot())
+        {
+            slot->fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static std::size_t & threadCount()
+    {
+        thread_local std::size_t count = 0;
+        return count;
+    }
+
+    static std::atomic<std::size_t> & totalCount()
+    {
+        static std::atomic<std::size_t> count {0};
+        return count;
+    }
+
+    static std::atomic<std::size_t> *& threadSlot()
+    {
+        thread_local std::atomic<std::size_t> * slot = nullptr;
+        return slot;
+    }
+
+    static std::atomic<std::size_t> * slots()
+    {
+        static std::atomic<std::size_t> counts[kSlotCount] {};
+        return counts;
+    }
+};
+
+#ifdef LEARNOPENGL_COUNT_ALLOCATIONS
+
+void * operator new(std::size_t size)
+{
+    AllocationCounter::record();
+
+    if (void * p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void * p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif // LEARNOPENGL_COUNT_ALLOCATIONS
+
+
+// A linear (bump) allocator for data that lives for one frame.
+//
+// allocate() only advances an offset; nothing is freed individually and reset() releases everything at once.
+// When a frame needed more than one block, reset() replaces them by a single block of their combined size, so after
+// the first frames at peak load the arena never touches the heap again. Destructors are not run: store trivially
+// destructible data only.
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t blockSize = 64 * 1024) : blockSize(blockSize)
+    {
+    }
+
+    FrameArena(FrameArena &&) = default;
+
+    FrameArena & operator=(FrameArena &&) = default;
+
+    void * allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        while (current < blocks.size())
+        {
+            Block & block = blocks[current];
+            auto base = reinterpret_cast<std::uintptr_t>(block.data.get());
+            std::size_t aligned = (base + offset + alignment - 1) / alignment * alignment - base;
+
+            if (aligned + size <= block.size)
+            {
+                offset = aligned + size;
+                used += size;
+                return block.data.get() + aligned;
+            }
+
+            ++current;
+            offset = 0;
+        }
+
+        std::size_t newSize = std::max(blockSize, size + alignment);
+        blocks.push_back({std::unique_ptr<char[]>(new char[newSize]), newSize});
+        ++blockAllocations;
+        offset = 0;
+
+        return allocate(size, alignment);
+    }
+
+    template <typename T>
+    T * allocate(std::size_t count)
+    {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // frees everything allocated since the last reset
+    void reset()
+    {
+        if (blocks.size() > 1)
+        {
+            std::size_t total = 0;
+
+            for (const Block & block : blocks)
+            {
+                total += block.size;
+            }
+
+            blocks.clear();
+            blocks.push_back({std::unique_ptr<char[]>(new char[total]), total});
+            ++blockAllocations;
+        }
+
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    // bytes handed out since the last reset
+    std::size_t getUsed() const
+    {
+        return used;
+    }
+
+    std::size_t getCapacity() const
+    {
+        std::size_t total = 0;
+
+        for (const Block & block : blocks)
+        {
+            total += block.size;
+        }
+
+        return total;
+    }
+
+    // times the arena itself went to the heap; stays constant in the steady state
+    std::size_t getBlockAllocations() const
+    {
+        return blockAllocations;
+    }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks;
+    std::size_t blockSize;
+    std::size_t current {0};
+    std::size_t offset {0};
+    std::size_t used {0};
+    std::size_t blockAllocations {0};
+};
+
+
+// One arena per job thread, so jobs allocate without synchronizing; index with the JobSystem's getThreadIndex().
+class FrameArenas
+{
+public:
+    explicit FrameArenas(unsigned int threadCount = 0, std::size_t blockSize = 64 * 1024) : blockSize(blockSize)
+    {
+        resize(threadCount);
+    }
+
+    // not thread-safe: size for the job system before handing the arenas to jobs
+    void resize(unsigned int threadCount)
+    {
+        while (arenas.size() < threadCount)
+        {
+            arenas.emplace_back(blockSize);
+        }
+
+        while (arenas.size() > threadCount)
+        {
+            arenas.pop_back();
+        }
+    }
+
+    unsigned int size() const
+    {
+        return static_cast<unsigned int>(arenas.size());
+    }
+
+    FrameArena & operator[](unsigned int thread)
+    {
+        return arenas[thread];
+    }
+
+    void reset()
+    {
+        for (FrameArena & arena : arenas)
+        {
+            arena.reset();
+        }
+    }
+
+    std::size_t getUsed() const
+    {
+        std::size_t total = 0;
+
+        for (const FrameArena & arena : arenas)
+        {
+            total += arena.getUsed();
+        }
+
+        return total;
+    }
+
+private:
+    std::vector<FrameArena> arenas;
+    std::size_t blockSize;
+};
+
+
+// STL allocator over a FrameArena, e.g. FrameVector<int> v {ArenaAllocator<int>(arena)};
+// deallocate() is a no-op, the memory comes back with the arena's reset().
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena & arena) : arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> & other) : arena(other.arena)
+    {
+    }
+
+    T * allocate(std::size_t count)
+    {
+        return arena->allocate<T>(count);
+    }
+
+    void deallocate(T *, std::size_t)
+    {
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> & other) const
+    {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> & other) const
+    {
+        return arena != other.arena;
+    }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena * arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // LEARNOPENGL_FRAME_ARENA_H
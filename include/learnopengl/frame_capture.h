@@ -0,0 +1,384 @@
+#ifndef LEARNOPENGL_FRAME_CAPTURE_H
+#define LEARNOPENGL_FRAME_CAPTURE_H
+
+#include <glad/glad.h>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Records the default framebuffer to a video file without stalling the render loop.
+//
+// Each captured frame is read into one of a ring of pixel pack buffers and fenced; the copy out of a buffer happens
+// only once its fence has signaled, a few frames later, so glReadPixels never waits on the GPU. The copied frames go
+// to a writer thread that encodes them, as raw Y4M (4:2:0) when the path ends in ".y4m" and through cv::VideoWriter
+// otherwise. Nothing blocks on a slow encoder or GPU: when every pack buffer is still in flight or every frame
+// buffer is still queued for the writer, the frame is dropped and counted instead.
+class FrameCapture
+{
+public:
+    struct Stats
+    {
+        unsigned long long captured;   // frames read back and handed to the writer
+        unsigned long long dropped;    // frames skipped for backpressure
+        unsigned long long written;    // frames encoded
+    };
+
+public:
+    // width and height of the captured region, anchored at the lower left corner of the framebuffer;
+    // call with the context current, and destroy the capture (or call finish()) while it still is
+    FrameCapture(const std::string & path, int width, int height, double fps = 60.0,
+                 int readbackSlots = 3, int queuedFrames = 4) :
+            path(path),
+            width(width & ~1),
+            height(height & ~1),
+            fps(fps),
+            slots(static_cast<std::size_t>(std::max(1, readbackSlots))),
+            frames(static_cast<std::size_t>(std::max(1, queuedFrames)))
+    {
+        std::size_t frameBytes = static_cast<std::size_t>(this->width) * this->height * 4;
+
+        for (Slot & slot : slots)
+        {
+            glGenBuffers(1, &slot.pbo);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frameBytes), nullptr, GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        for (std::size_t i = 0; i != frames.size(); ++i)
+        {
+            frames[i].resize(frameBytes);
+            freeFrames.push_back(i);
+        }
+
+        openOutput();
+        writer = std::thread(&FrameCapture::writeLoop, this);
+    }
+
+    FrameCapture(const FrameCapture &) = delete;
+
+    FrameCapture & operator=(const FrameCapture &) = delete;
+
+    ~FrameCapture()
+    {
+        finish();
+    }
+
+    // after a frame is drawn and before glfwSwapBuffers
+    void capture()
+    {
+        collect(false);
+
+        Slot & slot = slots[next];
+
+        if (slot.fence)
+        {
+            // the oldest readback is still on the GPU: drop this frame rather than wait for it
+            std::lock_guard<std::mutex> lock(mutex);
+            ++dropped;
+            return;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glReadBuffer(GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        // BGRA is the layout drivers read back without conversion
+        glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        next = (next + 1) % slots.size();
+    }
+
+    // waits for the readbacks in flight and for the writer to drain, then closes the file
+    void finish()
+    {
+        if (!writer.joinable())
+        {
+            return;
+        }
+
+        collect(true);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+
+        condition.notify_all();
+        writer.join();
+
+        for (Slot & slot : slots)
+        {
+            glDeleteBuffers(1, &slot.pbo);
+        }
+
+        if (videoWriter.isOpened())
+        {
+            videoWriter.release();
+        }
+
+        y4m.close();
+    }
+
+    Stats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return {captured, dropped, written};
+    }
+
+private:
+    struct Slot
+    {
+        unsigned int pbo {0};
+        GLsync fence {nullptr};
+    };
+
+    // copies finished readbacks, oldest first, into free frames for the writer
+    void collect(bool wait)
+    {
+        for (std::size_t n = 0; n != slots.size(); ++n)
+        {
+            Slot & slot = slots[(next + n) % slots.size()];
+
+            if (!slot.fence)
+            {
+                continue;
+            }
+
+            GLuint64 timeout = wait ? 1000000000 : 0;
+            GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+
+            while (wait && status == GL_TIMEOUT_EXPIRED)
+            {
+                status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            }
+
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                // later slots were issued later and cannot be done either
+                break;
+            }
+
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            std::size_t frame;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (freeFrames.empty())
+                {
+                    // the writer is behind by a full queue
+                    ++dropped;
+                    continue;
+                }
+
+                frame = freeFrames.back();
+                freeFrames.pop_back();
+            }
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            auto * pixels = static_cast<const unsigned char *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+            if (pixels)
+            {
+                std::memcpy(frames[frame].data(), pixels, frames[frame].size());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (pixels)
+                {
+                    queuedFrames.push_back(frame);
+                    ++captured;
+                }
+                else
+                {
+                    freeFrames.push_back(frame);
+                    ++dropped;
+                }
+            }
+
+            condition.notify_all();
+        }
+    }
+
+    void openOutput()
+    {
+        bool y4mOutput = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+
+        if (y4mOutput)
+        {
+            y4m.open(path, std::ofstream::out | std::ofstream::binary);
+
+            // frame rate as a fraction in thousandths
+            y4m << "YUV4MPEG2 W" << width << " H" << height
+                << " F" << static_cast<long>(fps * 1000.0 + 0.5) << ":1000 Ip A1:1 C420jpeg\n";
+        }
+        else
+        {
+            videoWriter.open(path, cv::VideoWriter::fourcc('m', 'p', '4', 'v'), fps, cv::Size(width, height), true);
+        }
+
+        if (y4mOutput ? !y4m : !videoWriter.isOpened())
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Failed to open " << path << " for recording"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+    }
+
+    void writeLoop()
+    {
+        while (true)
+        {
+            std::size_t frame;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return !queuedFrames.empty() || !running; });
+
+                if (queuedFrames.empty())
+                {
+                    break;
+                }
+
+                frame = queuedFrames.front();
+                queuedFrames.pop_front();
+            }
+
+            if (y4m.is_open())
+            {
+                writeY4m(frames[frame].data());
+            }
+            else
+            {
+                // bottom-up BGRA to the top-down BGR frames VideoWriter takes
+                cv::Mat bgra(height, width, CV_8UC4, frames[frame].data());
+                cv::cvtColor(bgra, image, cv::COLOR_BGRA2BGR);
+                cv::flip(image, image, 0);
+                videoWriter.write(image);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                freeFrames.push_back(frame);
+                ++written;
+            }
+        }
+    }
+
+    // full-range BT.601, chroma averaged over 2x2 pixels, rows flipped to top-down
+    void writeY4m(const unsigned char * bgra)
+    {
+        std::size_t lumaSize = static_cast<std::size_t>(width) * height;
+        yuv.resize(lumaSize + lumaSize / 2);
+
+        unsigned char * luma = yuv.data();
+        unsigned char * cb = luma + lumaSize;
+        unsigned char * cr = cb + lumaSize / 4;
+
+        for (int y = 0; y != height; ++y)
+        {
+            const unsigned char * row = bgra + static_cast<std::size_t>(height - 1 - y) * width * 4;
+
+            for (int x = 0; x != width; ++x)
+            {
+                const unsigned char * p = row + x * 4;
+                luma[static_cast<std::size_t>(y) * width + x] = toByte(0.114f * p[0] + 0.587f * p[1] + 0.299f * p[2]);
+            }
+        }
+
+        for (int y = 0; y != height / 2; ++y)
+        {
+            const unsigned char * row0 = bgra + static_cast<std::size_t>(height - 1 - 2 * y) * width * 4;
+            const unsigned char * row1 = row0 - static_cast<std::size_t>(width) * 4;
+
+            for (int x = 0; x != width / 2; ++x)
+            {
+                float b = 0.0f;
+                float g = 0.0f;
+                float r = 0.0f;
+
+                for (const unsigned char * p : {row0 + x * 8, row0 + x * 8 + 4, row1 + x * 8, row1 + x * 8 + 4})
+                {
+                    b += p[0];
+                    g += p[1];
+                    r += p[2];
+                }
+
+                b *= 0.25f;
+                g *= 0.25f;
+                r *= 0.25f;
+
+                std::size_t i = static_cast<std::size_t>(y) * (width / 2) + x;
+                cb[i] = toByte(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+                cr[i] = toByte(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+            }
+        }
+
+        y4m << "FRAME\n";
+        y4m.write(reinterpret_cast<const char *>(yuv.data()), static_cast<std::streamsize>(yuv.size()));
+    }
+
+    static unsigned char toByte(float v)
+    {
+        return static_cast<unsigned char>(std::min(255.0f, std::max(0.0f, v + 0.5f)));
+    }
+
+private:
+    std::string path;
+    int width;
+    int height;
+    double fps;
+
+    // render thread only
+    std::vector<Slot> slots;
+    std::size_t next {0};
+
+    // frame buffers move between the free list and the writer queue under the mutex
+    std::vector<std::vector<unsigned char>> frames;
+    std::vector<std::size_t> freeFrames;
+    std::deque<std::size_t> queuedFrames;
+
+    std::thread writer;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    bool running {true};
+
+    unsigned long long captured {0};
+    unsigned long long dropped {0};
+    unsigned long long written {0};
+
+    // writer thread only
+    std::ofstream y4m;
+    cv::VideoWriter videoWriter;
+    cv::Mat image;
+    std::vector<unsigned char> yuv;
+};
+
+#endif // LEARNOPENGL_FRAME_CAPTURE_H
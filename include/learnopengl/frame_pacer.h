@@ -0,0 +1,220 @@
+#ifndef LEARNOPENGL_FRAME_PACER_H
+#define LEARNOPENGL_FRAME_PACER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <thread>
+
+
+enum class VsyncMode
+{
+    Off,        // present immediately: lowest latency, tearing, the GPU runs flat out unless capped
+    On,         // wait for vertical blank: no tearing, up to a refresh of queued latency
+    Adaptive    // vsync while the frame rate keeps up, tear instead of halving it when a frame is late
+};
+
+
+// Paces the render loop and measures input-to-present latency.
+//
+// beginFrame() waits until the next frame is due under the FPS cap and then marks the moment input is sampled, so
+// a capped frame waits before its input, not after: the wait adds no latency. The wait sleeps until shortly before
+// the deadline, since sleep only guarantees a minimum, and spins for the rest. endFrame() swaps and fences; the
+// latency of a frame is taken when its fence is first seen signaled (the GPU finished the frame and the swap is
+// queued), polled at the next beginFrame() and while waiting, so it is an upper bound within one poll.
+class FramePacer
+{
+public:
+    struct Stats
+    {
+        double fps;              // over the last second
+        double latency;          // mean input-to-present latency in seconds, over the last second
+        double maxLatency;       // over the last second
+        unsigned long long frames;
+    };
+
+public:
+    // targetFps 0 leaves the rate to the swap interval; spinMargin is how long before a deadline sleeping stops
+    explicit FramePacer(VsyncMode mode = VsyncMode::On, double targetFps = 0.0, double spinMargin = 0.002) :
+            mode(mode),
+            period(targetFps > 0.0 ? 1.0 / targetFps : 0.0),
+            spinMargin(spinMargin)
+    {
+    }
+
+    // parses "off", "on" or "adaptive"; anything else leaves mode unchanged and returns false
+    static bool parseMode(const char * name, VsyncMode & mode)
+    {
+        if (!std::strcmp(name, "off"))
+        {
+            mode = VsyncMode::Off;
+        }
+        else if (!std::strcmp(name, "on"))
+        {
+            mode = VsyncMode::On;
+        }
+        else if (!std::strcmp(name, "adaptive"))
+        {
+            mode = VsyncMode::Adaptive;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    // sets the swap interval of the current context
+    void apply()
+    {
+        int interval = mode == VsyncMode::Off ? 0 : 1;
+
+        if (mode == VsyncMode::Adaptive)
+        {
+            // a negative interval requests late swap tearing, only where the platform exposes it
+            if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+            {
+                interval = -1;
+            }
+            else
+            {
+                std::cout << "adaptive vsync is not supported, falling back to vsync on" << std::endl;
+            }
+        }
+
+        glfwSwapInterval(interval);
+        next = Clock::now();
+        windowStart = next;
+    }
+
+    // waits out the FPS cap, then marks this frame's input time; call right before polling input
+    void beginFrame()
+    {
+        if (period > 0.0)
+        {
+            Clock::time_point now = Clock::now();
+            Clock::duration step = toDuration(period);
+
+            // a late frame moves the schedule to now instead of running the missed frames back to back
+            next = std::max(next + step, now);
+
+            // sleep in small slices, so the fences are polled while waiting
+            while (now + toDuration(spinMargin) < next)
+            {
+                std::this_thread::sleep_for(std::min(next - now - toDuration(spinMargin), toDuration(0.001)));
+                pollFences();
+                now = Clock::now();
+            }
+
+            while (Clock::now() < next)
+            {
+            }
+        }
+
+        pollFences();
+        inputTime = Clock::now();
+    }
+
+    // presents the frame
+    void endFrame(GLFWwindow * window)
+    {
+        glfwSwapBuffers(window);
+        inFlight.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), inputTime});
+        ++frames;
+        ++windowFrames;
+
+        Clock::time_point now = Clock::now();
+        double elapsed = seconds(now - windowStart);
+
+        if (elapsed >= 1.0)
+        {
+            stats.fps = windowFrames / elapsed;
+            stats.latency = windowLatencies ? windowLatency / windowLatencies : 0.0;
+            stats.maxLatency = windowMaxLatency;
+            windowStart = now;
+            windowFrames = 0;
+            windowLatency = 0.0;
+            windowLatencies = 0;
+            windowMaxLatency = 0.0;
+        }
+
+        stats.frames = frames;
+    }
+
+    Stats getStats() const
+    {
+        return stats;
+    }
+
+    // deletes the fences still pending; call while the context is current
+    void release()
+    {
+        for (const Pending & pending : inFlight)
+        {
+            glDeleteSync(pending.fence);
+        }
+
+        inFlight.clear();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending
+    {
+        GLsync fence;
+        Clock::time_point inputTime;
+    };
+
+    static Clock::duration toDuration(double s)
+    {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(s));
+    }
+
+    static double seconds(Clock::duration d)
+    {
+        return std::chrono::duration<double>(d).count();
+    }
+
+    void pollFences()
+    {
+        while (!inFlight.empty() &&
+               glClientWaitSync(inFlight.front().fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) != GL_TIMEOUT_EXPIRED)
+        {
+            double latency = seconds(Clock::now() - inFlight.front().inputTime);
+            windowLatency += latency;
+            windowMaxLatency = std::max(windowMaxLatency, latency);
+            ++windowLatencies;
+
+            glDeleteSync(inFlight.front().fence);
+            inFlight.pop_front();
+        }
+    }
+
+private:
+    VsyncMode mode;
+    double period;
+    double spinMargin;
+
+    Clock::time_point next;
+    Clock::time_point inputTime;
+    std::deque<Pending> inFlight;
+
+    unsigned long long frames {0};
+    Clock::time_point windowStart;
+    unsigned long long windowFrames {0};
+    double windowLatency {0.0};
+    unsigned long long windowLatencies {0};
+    double windowMaxLatency {0.0};
+
+    Stats stats {0.0, 0.0, 0.0, 0};
+};
+
+#endif // LEARNOPENGL_FRAME_PACER_H
@@ -0,0 +1,707 @@
+#ifndef LEARNOPENGL_GL_RESOURCE_H
+#define LEARNOPENGL_GL_RESOURCE_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// what a GL object's memory is accounted as
+enum class GlCategory
+{
+    Geometry,
+    Texture,
+    RenderTarget,
+    Readback,
+    Other,
+    Count
+};
+
+
+enum class GlObjectKind
+{
+    Buffer,
+    Texture,
+    VertexArray,
+    Framebuffer,
+    Renderbuffer
+};
+
+
+// The GL objects alive through the wrappers below, with their storage (size, format, mip levels), summed per category.
+//
+// Every wrapper registers its object when created and unregisters it when deleted, so whatever is still registered
+// when the context is about to go away was leaked; reportLeaks() lists it. Sizes are what the storage calls asked
+// for, not what the driver allocates (padding, compression, mirrored copies), so they are a lower bound; see
+// gpu_memory.h for what the driver reports.
+class GlResourceTracker
+{
+public:
+    struct CategoryStats
+    {
+        std::size_t objects;
+        std::size_t bytes;
+    };
+
+public:
+    static GlResourceTracker & instance()
+    {
+        static GlResourceTracker tracker;
+        return tracker;
+    }
+
+    static const char * getCategoryName(GlCategory category)
+    {
+        static const char * names[] = {"geometry", "texture", "render target", "readback", "other"};
+        return names[static_cast<int>(category)];
+    }
+
+    static const char * getKindName(GlObjectKind kind)
+    {
+        static const char * names[] = {"buffer", "texture", "vertex array", "framebuffer", "renderbuffer"};
+        return names[static_cast<int>(kind)];
+    }
+
+    void add(GlObjectKind kind, unsigned int name, GlCategory category, const char * label)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        objects[{kind, name}] = {category, label, 0, 0, 0, 0, 0};
+        ++categories[static_cast<int>(category)].objects;
+    }
+
+    void remove(GlObjectKind kind, unsigned int name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = objects.find({kind, name});
+
+        if (it != objects.end())
+        {
+            CategoryStats & stats = categories[static_cast<int>(it->second.category)];
+            --stats.objects;
+            stats.bytes -= it->second.bytes;
+            totalBytes -= it->second.bytes;
+            objects.erase(it);
+        }
+    }
+
+    // internalFormat, width, height and levels describe textures and renderbuffers, 0 for buffers
+    void setStorage(GlObjectKind kind, unsigned int name, std::size_t bytes, GLenum internalFormat = 0, int width = 0,
+                    int height = 0, int levels = 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = objects.find({kind, name});
+
+        if (it != objects.end())
+        {
+            CategoryStats & stats = categories[static_cast<int>(it->second.category)];
+            stats.bytes = stats.bytes - it->second.bytes + bytes;
+            totalBytes = totalBytes - it->second.bytes + bytes;
+            it->second.bytes = bytes;
+            it->second.internalFormat = internalFormat;
+            it->second.width = width;
+            it->second.height = height;
+            it->second.levels = levels;
+        }
+    }
+
+    CategoryStats getStats(GlCategory category)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return categories[static_cast<int>(category)];
+    }
+
+    // of all categories
+    std::size_t getTotalBytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return totalBytes;
+    }
+
+    // one line per category with live objects, and with allocations one per object, largest first
+    void printReport(std::ostream & out = std::cout, bool allocations = false)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (int c = 0; c != static_cast<int>(GlCategory::Count); ++c)
+        {
+            if (categories[c].objects != 0)
+            {
+                out << "[INFO] GL " << getCategoryName(static_cast<GlCategory>(c)) << ": " << categories[c].objects
+                    << " objects, " << std::fixed << std::setprecision(2) << categories[c].bytes / 1048576.0
+                    << " MB" << std::defaultfloat << '\n';
+            }
+        }
+
+        if (allocations)
+        {
+            std::vector<const std::pair<const Key, Entry> *> sorted;
+
+            for (const auto & entry : objects)
+            {
+                sorted.push_back(&entry);
+            }
+
+            std::sort(sorted.begin(), sorted.end(), [](const auto * lhs, const auto * rhs)
+            {
+                return lhs->second.bytes > rhs->second.bytes;
+            });
+
+            for (const auto * entry : sorted)
+            {
+                out << "[INFO]   ";
+                printObject(out, *entry);
+                out << '\n';
+            }
+        }
+
+        out.flush();
+    }
+
+    // lists the objects still alive and returns their count; call just before the context is destroyed
+    std::size_t reportLeaks(std::ostream & out = std::cout)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (const auto & entry : objects)
+        {
+            out << "[WARNING] ";
+            printObject(out, entry);
+            out << " was never deleted\n";
+        }
+
+        out.flush();
+
+        return objects.size();
+    }
+
+private:
+    using Key = std::pair<GlObjectKind, unsigned int>;
+
+    struct Entry
+    {
+        GlCategory category;
+        std::string label;
+        std::size_t bytes;
+        GLenum internalFormat;
+        int width;
+        int height;
+        int levels;
+    };
+
+    GlResourceTracker() = default;
+
+    // e.g. GL texture 7 "etc/brick.jpg" (texture, 512x512 0x8051 x 10 levels, 1398100 bytes)
+    static void printObject(std::ostream & out, const std::pair<const Key, Entry> & entry)
+    {
+        const Entry & object = entry.second;
+        out << "GL " << getKindName(entry.first.first) << ' ' << entry.first.second << " \"" << object.label
+            << "\" (" << getCategoryName(object.category) << ", ";
+
+        if (object.internalFormat != 0)
+        {
+            out << object.width << 'x' << object.height << " 0x" << std::hex << object.internalFormat << std::dec;
+
+            if (object.levels > 1)
+            {
+                out << " x " << object.levels << " levels";
+            }
+
+            out << ", ";
+        }
+
+        out << object.bytes << " bytes)";
+    }
+
+    std::mutex mutex;
+    std::map<Key, Entry> objects;
+    CategoryStats categories[static_cast<int>(GlCategory::Count)] {};
+    std::size_t totalBytes {0};
+};
+
+
+// Owns one GL object: generated on construction, deleted on destruction or reset(), movable but not copyable.
+// Default construction holds no object. Must be reset or destroyed while the context is current.
+template <GlObjectKind Kind>
+class GlObject
+{
+public:
+    GlObject() = default;
+
+    explicit GlObject(GlCategory category, const char * label = "")
+    {
+        switch (Kind)
+        {
+            case GlObjectKind::Buffer:
+                glGenBuffers(1, &name);
+                break;
+            case GlObjectKind::Texture:
+                glGenTextures(1, &name);
+                break;
+            case GlObjectKind::VertexArray:
+                glGenVertexArrays(1, &name);
+                break;
+            case GlObjectKind::Framebuffer:
+                glGenFramebuffers(1, &name);
+                break;
+            case GlObjectKind::Renderbuffer:
+                glGenRenderbuffers(1, &name);
+                break;
+        }
+
+        GlResourceTracker::instance().add(Kind, name, category, label);
+    }
+
+    GlObject(const GlObject &) = delete;
+
+    GlObject & operator=(const GlObject &) = delete;
+
+    GlObject(GlObject && other) noexcept : name(other.name)
+    {
+        other.name = 0;
+    }
+
+    GlObject & operator=(GlObject && other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            name = other.name;
+            other.name = 0;
+        }
+
+        return *this;
+    }
+
+    ~GlObject()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        if (!name)
+        {
+            return;
+        }
+
+        GlResourceTracker::instance().remove(Kind, name);
+
+        switch (Kind)
+        {
+            case GlObjectKind::Buffer:
+                glDeleteBuffers(1, &name);
+                break;
+            case GlObjectKind::Texture:
+                glDeleteTextures(1, &name);
+                break;
+            case GlObjectKind::VertexArray:
+                glDeleteVertexArrays(1, &name);
+                break;
+            case GlObjectKind::Framebuffer:
+                glDeleteFramebuffers(1, &name);
+                break;
+            case GlObjectKind::Renderbuffer:
+                glDeleteRenderbuffers(1, &name);
+                break;
+        }
+
+        name = 0;
+    }
+
+    unsigned int get() const
+    {
+        return name;
+    }
+
+    explicit operator bool() const
+    {
+        return name != 0;
+    }
+
+protected:
+    void setStorage(std::size_t bytes, GLenum internalFormat = 0, int width = 0, int height = 0, int levels = 0) const
+    {
+        GlResourceTracker::instance().setStorage(Kind, name, bytes, internalFormat, width, height, levels);
+    }
+
+private:
+    unsigned int name {0};
+};
+
+
+using GlVertexArray = GlObject<GlObjectKind::VertexArray>;
+using GlFramebuffer = GlObject<GlObjectKind::Framebuffer>;
+
+
+class GlBuffer : public GlObject<GlObjectKind::Buffer>
+{
+public:
+    using GlObject::GlObject;
+
+    // binds the buffer to target and gives it storage of bytes (glBufferData), accounted to its category
+    void allocate(GLenum target, std::size_t bytes, GLenum usage, const void * data = nullptr)
+    {
+        glBindBuffer(target, get());
+        glBufferData(target, static_cast<GLsizeiptr>(bytes), data, usage);
+        capacity = bytes;
+        this->usage = usage;
+        setStorage(bytes);
+    }
+
+    std::size_t getCapacity() const
+    {
+        return capacity;
+    }
+
+    GLenum getUsage() const
+    {
+        return usage;
+    }
+
+private:
+    std::size_t capacity {0};
+    GLenum usage {GL_STATIC_DRAW};
+};
+
+
+// bytes per texel of the common internal formats; three-component formats count as four, as drivers pad them
+inline std::size_t getTexelBytes(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+            return 1;
+        case GL_RG8:
+        case GL_R16F:
+            return 2;
+        case GL_RGBA16F:
+        case GL_RGBA16UI:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+
+class GlTexture : public GlObject<GlObjectKind::Texture>
+{
+public:
+    using GlObject::GlObject;
+
+    // binds the texture to GL_TEXTURE_2D and allocates levels mip levels of internalFormat, level 0 from pixels if
+    // given; the other levels are left for glGenerateMipmap
+    void allocate2D(GLenum internalFormat, int width, int height, int levels, GLenum format, GLenum type,
+                    const void * pixels = nullptr)
+    {
+        glBindTexture(GL_TEXTURE_2D, get());
+
+        for (int level = 0; level != levels; ++level)
+        {
+            glTexImage2D(GL_TEXTURE_2D, level, static_cast<GLint>(internalFormat), std::max(1, width >> level),
+                         std::max(1, height >> level), 0, format, type, level == 0 ? pixels : nullptr);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+        this->internalFormat = internalFormat;
+        this->width = width;
+        this->height = height;
+        this->levels = levels;
+        setStorage(getBytes(), internalFormat, width, height, levels);
+    }
+
+    // of all levels
+    std::size_t getBytes() const
+    {
+        std::size_t bytes = 0;
+
+        for (int level = 0; level != levels; ++level)
+        {
+            bytes += static_cast<std::size_t>(std::max(1, width >> level)) * std::max(1, height >> level) *
+                     getTexelBytes(internalFormat);
+        }
+
+        return bytes;
+    }
+
+    // the full mip chain of a width x height texture
+    static int getLevelCount(int width, int height)
+    {
+        int levels = 1;
+
+        while ((std::max(width, height) >> levels) != 0)
+        {
+            ++levels;
+        }
+
+        return levels;
+    }
+
+    GLenum getInternalFormat() const
+    {
+        return internalFormat;
+    }
+
+    int getWidth() const
+    {
+        return width;
+    }
+
+    int getHeight() const
+    {
+        return height;
+    }
+
+    int getLevels() const
+    {
+        return levels;
+    }
+
+private:
+    GLenum internalFormat {GL_RGBA8};
+    int width {0};
+    int height {0};
+    int levels {0};
+};
+
+
+class GlRenderbuffer : public GlObject<GlObjectKind::Renderbuffer>
+{
+public:
+    using GlObject::GlObject;
+
+    // binds the renderbuffer and allocates its storage (glRenderbufferStorage)
+    void allocate(GLenum internalFormat, int width, int height)
+    {
+        glBindRenderbuffer(GL_RENDERBUFFER, get());
+        glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+        std::size_t bytes = static_cast<std::size_t>(width) * height * getTexelBytes(internalFormat);
+        setStorage(bytes, internalFormat, width, height, 1);
+    }
+};
+
+
+struct GlPoolStats
+{
+    unsigned long long hits;
+    unsigned long long misses;
+    std::size_t pooled;         // objects waiting for reuse
+    std::size_t pooledBytes;
+};
+
+
+// Buffers kept for reuse by usage and power-of-two size class.
+//
+// acquire() returns a released buffer of the same class if there is one, otherwise a new one; either way its
+// capacity is at least the requested size and its contents are undefined. tryAcquire() only takes from the pool and
+// returns an empty buffer when nothing matches. Released buffers beyond maxPooledBytes are deleted, oldest first.
+// Buffers never released are simply deleted by their destructor.
+class GlBufferPool
+{
+public:
+    explicit GlBufferPool(GlCategory category, std::size_t maxPooledBytes = 32u << 20, const char * label = "pooled") :
+            category(category),
+            maxPooledBytes(maxPooledBytes),
+            label(label)
+    {
+    }
+
+    GlBufferPool(const GlBufferPool &) = delete;
+
+    GlBufferPool & operator=(const GlBufferPool &) = delete;
+
+    GlBuffer acquire(std::size_t bytes, GLenum usage)
+    {
+        GlBuffer buffer = tryAcquire(bytes, usage);
+
+        if (buffer)
+        {
+            return buffer;
+        }
+
+        // allocated through the copy-write binding, so no vertex array's element buffer binding is disturbed
+        buffer = GlBuffer(category, label);
+        buffer.allocate(GL_COPY_WRITE_BUFFER, getSizeClass(bytes), usage);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        ++misses;
+
+        return buffer;
+    }
+
+    GlBuffer tryAcquire(std::size_t bytes, GLenum usage)
+    {
+        std::size_t capacity = getSizeClass(bytes);
+
+        auto it = std::find_if(pooled.begin(), pooled.end(), [&](const GlBuffer & buffer)
+        {
+            return buffer.getCapacity() == capacity && buffer.getUsage() == usage;
+        });
+
+        if (it == pooled.end())
+        {
+            return GlBuffer();
+        }
+
+        GlBuffer buffer = std::move(*it);
+        pooled.erase(it);
+        pooledBytes -= capacity;
+        ++hits;
+
+        return buffer;
+    }
+
+    void release(GlBuffer buffer)
+    {
+        if (!buffer)
+        {
+            return;
+        }
+
+        pooledBytes += buffer.getCapacity();
+        pooled.push_back(std::move(buffer));
+        trim(maxPooledBytes);
+    }
+
+    // deletes pooled buffers, oldest first, until at most maxBytes are pooled
+    void trim(std::size_t maxBytes)
+    {
+        while (pooledBytes > maxBytes && !pooled.empty())
+        {
+            pooledBytes -= pooled.front().getCapacity();
+            pooled.pop_front();
+        }
+    }
+
+    GlPoolStats getStats() const
+    {
+        return {hits, misses, pooled.size(), pooledBytes};
+    }
+
+    static std::size_t getSizeClass(std::size_t bytes)
+    {
+        std::size_t capacity = 256;
+
+        while (capacity < bytes)
+        {
+            capacity <<= 1;
+        }
+
+        return capacity;
+    }
+
+private:
+    GlCategory category;
+    std::size_t maxPooledBytes;
+    const char * label;
+
+    std::deque<GlBuffer> pooled;
+    std::size_t pooledBytes {0};
+    unsigned long long hits {0};
+    unsigned long long misses {0};
+};
+
+
+// 2D textures kept for reuse by internal format, size and level count; otherwise as GlBufferPool.
+// A reused texture keeps the sampler parameters its last user set.
+class GlTexturePool
+{
+public:
+    explicit GlTexturePool(GlCategory category, std::size_t maxPooledBytes = 64u << 20,
+                           const char * label = "pooled") :
+            category(category),
+            maxPooledBytes(maxPooledBytes),
+            label(label)
+    {
+    }
+
+    GlTexturePool(const GlTexturePool &) = delete;
+
+    GlTexturePool & operator=(const GlTexturePool &) = delete;
+
+    // format and type only describe the (absent) pixels of a new allocation
+    GlTexture acquire(GLenum internalFormat, int width, int height, int levels, GLenum format, GLenum type)
+    {
+        GlTexture texture = tryAcquire(internalFormat, width, height, levels);
+
+        if (texture)
+        {
+            return texture;
+        }
+
+        texture = GlTexture(category, label);
+        texture.allocate2D(internalFormat, width, height, levels, format, type);
+        ++misses;
+
+        return texture;
+    }
+
+    GlTexture tryAcquire(GLenum internalFormat, int width, int height, int levels)
+    {
+        auto it = std::find_if(pooled.begin(), pooled.end(), [&](const GlTexture & texture)
+        {
+            return texture.getInternalFormat() == internalFormat && texture.getWidth() == width &&
+                   texture.getHeight() == height && texture.getLevels() == levels;
+        });
+
+        if (it == pooled.end())
+        {
+            return GlTexture();
+        }
+
+        GlTexture texture = std::move(*it);
+        pooled.erase(it);
+        pooledBytes -= texture.getBytes();
+        ++hits;
+
+        return texture;
+    }
+
+    void release(GlTexture texture)
+    {
+        if (!texture)
+        {
+            return;
+        }
+
+        pooledBytes += texture.getBytes();
+        pooled.push_back(std::move(texture));
+        trim(maxPooledBytes);
+    }
+
+    void trim(std::size_t maxBytes)
+    {
+        while (pooledBytes > maxBytes && !pooled.empty())
+        {
+            pooledBytes -= pooled.front().getBytes();
+            pooled.pop_front();
+        }
+    }
+
+    GlPoolStats getStats() const
+    {
+        return {hits, misses, pooled.size(), pooledBytes};
+    }
+
+private:
+    GlCategory category;
+    std::size_t maxPooledBytes;
+    const char * label;
+
+    std::deque<GlTexture> pooled;
+    std::size_t pooledBytes {0};
+    unsigned long long hits {0};
+    unsigned long long misses {0};
+};
+
+#endif // LEARNOPENGL_GL_RESOURCE_H
@@ -0,0 +1,216 @@
+#ifndef LEARNOPENGL_GPU_MEMORY_H
+#define LEARNOPENGL_GPU_MEMORY_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "learnopengl/gl_resource.h"
+
+
+// What the driver reports about video memory. Only NVIDIA (GL_NVX_gpu_memory_info) and AMD (GL_ATI_meminfo)
+// drivers report anything; elsewhere source is nullptr and the sizes are 0.
+struct GpuMemoryInfo
+{
+    const char * source;            // the extension the numbers come from
+    std::size_t totalBytes;         // dedicated video memory; 0 when unknown, GL_ATI_meminfo reporting free memory only
+    std::size_t availableBytes;     // free video memory
+    std::size_t evictedBytes;       // GL_NVX_gpu_memory_info: evicted to system memory since the context was created
+    int evictionCount;
+
+    // needs a current context; the queries do not wait for the GPU
+    static GpuMemoryInfo query()
+    {
+        GpuMemoryInfo info {nullptr, 0, 0, 0, 0};
+
+        // all sizes are in KB
+        if (GLAD_GL_NVX_gpu_memory_info)
+        {
+            GLint total = 0;
+            GLint available = 0;
+            GLint evicted = 0;
+            GLint evictions = 0;
+
+            glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, &total);
+            glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
+            glGetIntegerv(GL_GPU_MEMORY_INFO_EVICTED_MEMORY_NVX, &evicted);
+            glGetIntegerv(GL_GPU_MEMORY_INFO_EVICTION_COUNT_NVX, &evictions);
+
+            info.source = "GL_NVX_gpu_memory_info";
+            info.totalBytes = static_cast<std::size_t>(total) << 10;
+            info.availableBytes = static_cast<std::size_t>(available) << 10;
+            info.evictedBytes = static_cast<std::size_t>(evicted) << 10;
+            info.evictionCount = evictions;
+        }
+        else if (GLAD_GL_ATI_meminfo)
+        {
+            // total free, largest free block, total free auxiliary, largest free auxiliary block
+            GLint texture[4] {};
+            glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, texture);
+
+            info.source = "GL_ATI_meminfo";
+            info.availableBytes = static_cast<std::size_t>(texture[0]) << 10;
+        }
+
+        return info;
+    }
+};
+
+
+struct GpuMemoryBudgetSettings
+{
+    std::size_t trackedBudget {256u << 20};     // bytes of all objects in GlResourceTracker
+    std::size_t minimumAvailable {64u << 20};   // video memory the driver should keep free, where it reports it
+    float grantMargin {0.1f};                   // headroom under both budgets, as a fraction of trackedBudget,
+                                                // before memory is granted back
+    int queryInterval {30};                     // frames between driver queries
+};
+
+
+// Enforces budgets on GPU memory by asking the streaming systems to give memory back or allowing them to take more.
+//
+// Two budgets are checked once per frame: the bytes of all objects in GlResourceTracker against trackedBudget, and,
+// where the driver reports it, the free video memory against minimumAvailable, which also covers allocations the
+// tracker never sees (other applications, the window system, driver internals). When either is exceeded the
+// consumers are asked in the order they were added to reclaim the excess, e.g. by evicting or downscaling streamed
+// textures. Once there is headroom under both by more than grantMargin, each consumer is granted it and may grow
+// its own budget back; the margin keeps the two from alternating every frame.
+class GpuMemoryBudget
+{
+public:
+    // frees up to bytes (or arranges for them to be freed over the next frames) and returns how many it accounts for
+    using ReclaimCallback = std::function<std::size_t(std::size_t bytes)>;
+
+    // may use up to bytes more
+    using GrantCallback = std::function<void(std::size_t bytes)>;
+
+    explicit GpuMemoryBudget(const GpuMemoryBudgetSettings & settings = GpuMemoryBudgetSettings()) :
+            settings(settings)
+    {
+    }
+
+    void addConsumer(ReclaimCallback reclaim, GrantCallback grant)
+    {
+        consumers.emplace_back(std::move(reclaim), std::move(grant));
+    }
+
+    // call once per frame with the context current
+    void update()
+    {
+        std::size_t tracked = GlResourceTracker::instance().getTotalBytes();
+
+        if (frame++ % std::max(settings.queryInterval, 1) == 0)
+        {
+            driverInfo = GpuMemoryInfo::query();
+            queriedTrackedBytes = tracked;
+        }
+
+        std::size_t excess = tracked > settings.trackedBudget ? tracked - settings.trackedBudget : 0;
+        std::size_t headroom = settings.trackedBudget > tracked ? settings.trackedBudget - tracked : 0;
+
+        if (driverInfo.source)
+        {
+            // the driver's figure is up to queryInterval frames old; what was tracked since then is taken off it,
+            // and what was freed since then (e.g. by the last reclaim) is credited to it
+            std::size_t available = driverInfo.availableBytes;
+
+            if (tracked > queriedTrackedBytes)
+            {
+                std::size_t growth = tracked - queriedTrackedBytes;
+                available = available > growth ? available - growth : 0;
+            }
+            else
+            {
+                available += queriedTrackedBytes - tracked;
+            }
+
+            if (available < settings.minimumAvailable)
+            {
+                excess = std::max(excess, settings.minimumAvailable - available);
+            }
+
+            headroom = std::min(headroom, available > settings.minimumAvailable ?
+                                          available - settings.minimumAvailable : 0);
+        }
+
+        if (excess != 0)
+        {
+            ++reclaims;
+
+            for (auto & consumer : consumers)
+            {
+                std::size_t freed = consumer.first(excess);
+                excess -= std::min(excess, freed);
+
+                if (excess == 0)
+                {
+                    break;
+                }
+            }
+        }
+        else if (headroom > static_cast<std::size_t>(settings.grantMargin * settings.trackedBudget))
+        {
+            for (auto & consumer : consumers)
+            {
+                consumer.second(headroom);
+            }
+        }
+    }
+
+    // as of the last query
+    const GpuMemoryInfo & getDriverInfo() const
+    {
+        return driverInfo;
+    }
+
+    // the frames in which memory was reclaimed
+    unsigned long long getReclaims() const
+    {
+        return reclaims;
+    }
+
+    const GpuMemoryBudgetSettings & getSettings() const
+    {
+        return settings;
+    }
+
+    // the tracker's report, with what the driver reports
+    void printReport(std::ostream & out = std::cout, bool allocations = false)
+    {
+        GlResourceTracker::instance().printReport(out, allocations);
+        GpuMemoryInfo info = GpuMemoryInfo::query();
+
+        if (info.source)
+        {
+            out << "[INFO] " << info.source << ": " << (info.availableBytes >> 20) << " MB available";
+
+            if (info.totalBytes != 0)
+            {
+                out << " of " << (info.totalBytes >> 20) << " MB, " << info.evictionCount << " evictions ("
+                    << (info.evictedBytes >> 20) << " MB)";
+            }
+
+            out << std::endl;
+        }
+        else
+        {
+            out << "[INFO] the driver reports no video memory usage" << std::endl;
+        }
+    }
+
+private:
+    GpuMemoryBudgetSettings settings;
+    std::vector<std::pair<ReclaimCallback, GrantCallback>> consumers;
+
+    GpuMemoryInfo driverInfo {nullptr, 0, 0, 0, 0};
+    std::size_t queriedTrackedBytes {0};
+    unsigned long long frame {0};
+    unsigned long long reclaims {0};
+};
+
+#endif // LEARNOPENGL_GPU_MEMORY_H
@@ -0,0 +1,239 @@
+#ifndef LEARNOPENGL_HEADLESS_CAPTURE_H
+#define LEARNOPENGL_HEADLESS_CAPTURE_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <opencv2/opencv.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "learnopengl/image_compare.h"
+
+
+// Renders a sample to a fixed frame in a hidden window, then saves that frame or checks it against a golden image.
+//
+// Options, given to the sample:
+//   --capture <out.png>     writes the frame
+//   --golden <in.png>       compares the frame; on failure, or without a golden image, the sample exits with 1
+//   --output-dir <dir>      where a failed comparison writes <in>.actual.png and <in>.diff.png, the current
+//                           directory by default; the tests point it into the build directory
+//   --missing-golden skip   exits with HeadlessCapture::kSkipExitCode instead when there is no golden image, which
+//                           ctest reports as skipped
+//   --frame <n>             the frame to take, 10 by default
+//   --tolerance <t> --max-mismatch <r> --min-ssim <s>    the ImageTolerance of --golden
+// While capturing, time advances by exactly 1/60 s per frame, so every run renders the same image.
+class HeadlessCapture
+{
+public:
+    // the SKIP_RETURN_CODE of the golden-image tests, with --missing-golden skip
+    static constexpr int kSkipExitCode = 77;
+
+    HeadlessCapture(int argc, char * argv[])
+    {
+        for (int i = 1; i + 1 < argc; i += 2)
+        {
+            if (!std::strcmp(argv[i], "--capture"))
+            {
+                capturePath = argv[i + 1];
+            }
+            else if (!std::strcmp(argv[i], "--golden"))
+            {
+                goldenPath = argv[i + 1];
+            }
+            else if (!std::strcmp(argv[i], "--output-dir"))
+            {
+                outputDirectory = argv[i + 1];
+            }
+            else if (!std::strcmp(argv[i], "--missing-golden"))
+            {
+                if (std::strcmp(argv[i + 1], "skip") && std::strcmp(argv[i + 1], "fail"))
+                {
+                    std::cout << std::unitbuf
+                              << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                              << "\n[ERROR] " << "--missing-golden takes skip or fail!"
+                              << std::nounitbuf << std::endl;
+
+                    std::abort();
+                }
+
+                skipMissingGolden = !std::strcmp(argv[i + 1], "skip");
+            }
+            else if (!std::strcmp(argv[i], "--frame"))
+            {
+                targetFrame = std::atoi(argv[i + 1]);
+            }
+            else if (!std::strcmp(argv[i], "--tolerance"))
+            {
+                tolerance.channelTolerance = std::atoi(argv[i + 1]);
+            }
+            else if (!std::strcmp(argv[i], "--max-mismatch"))
+            {
+                tolerance.maxMismatchRatio = std::atof(argv[i + 1]);
+            }
+            else if (!std::strcmp(argv[i], "--min-ssim"))
+            {
+                tolerance.minSsim = std::atof(argv[i + 1]);
+            }
+        }
+    }
+
+    bool isActive() const
+    {
+        return !capturePath.empty() || !goldenPath.empty();
+    }
+
+    // before glfwCreateWindow
+    void applyWindowHints() const
+    {
+        if (isActive())
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
+    }
+
+    // replaces glfwGetTime in the sample's animation
+    double getTime() const
+    {
+        return isActive() ? static_cast<double>(frame) / 60.0 : glfwGetTime();
+    }
+
+    // after a frame is drawn and before glfwSwapBuffers; returns true once the sample is done and should close
+    bool endFrame(GLFWwindow * window)
+    {
+        if (!isActive() || frame++ != targetFrame)
+        {
+            return false;
+        }
+
+        int width;
+        int height;
+        glfwGetFramebufferSize(window, &width, &height);
+
+        cv::Mat image = readBackBuffer(width, height);
+
+        if (!capturePath.empty())
+        {
+            if (!cv::imwrite(capturePath, image))
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "Failed to write " << capturePath
+                          << std::nounitbuf << std::endl;
+
+                exitCode = 1;
+            }
+        }
+
+        if (!goldenPath.empty() && exitCode == 0)
+        {
+            exitCode = compareWithGolden(image);
+        }
+
+        return true;
+    }
+
+    // what the sample's main returns
+    int getExitCode() const
+    {
+        return exitCode;
+    }
+
+private:
+    // the back buffer through a pixel pack buffer, as a BGR image with the top row first
+    static cv::Mat readBackBuffer(int width, int height)
+    {
+        unsigned int pbo;
+        glGenBuffers(1, &pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * 3, nullptr, GL_STREAM_READ);
+
+        glReadBuffer(GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+
+        glDeleteSync(fence);
+
+        cv::Mat image(height, width, CV_8UC3);
+        auto * pixels = static_cast<const unsigned char *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+        if (pixels)
+        {
+            std::memcpy(image.data, pixels, static_cast<std::size_t>(width) * height * 3);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glDeleteBuffers(1, &pbo);
+
+        cv::flip(image, image, 0);
+        cv::cvtColor(image, image, cv::COLOR_RGB2BGR);
+
+        return image;
+    }
+
+    // the exit code: 0 if the frame matches, 1 if not, and 1 or kSkipExitCode if there is no golden image
+    int compareWithGolden(const cv::Mat & image) const
+    {
+        cv::Mat golden = cv::imread(goldenPath);
+
+        if (golden.empty())
+        {
+            std::cout << (skipMissingGolden ? "[SKIP] " : "[FAIL] ") << goldenPath
+                      << ": golden image missing, capture it with --capture" << std::endl;
+            return skipMissingGolden ? kSkipExitCode : 1;
+        }
+
+        ImageComparison result = ImageCompare::compare(image, golden, tolerance);
+
+        // <output dir>/<golden name without extension>
+        std::string name = goldenPath.substr(goldenPath.find_last_of('/') + 1);
+        std::error_code ec;
+        std::filesystem::create_directories(outputDirectory, ec);
+        std::string stem = outputDirectory + '/' + name.substr(0, name.rfind('.'));
+
+        if (!result.sizeMatches)
+        {
+            std::cout << "[FAIL] " << goldenPath << ": rendered " << image.cols << 'x' << image.rows
+                      << ", golden " << golden.cols << 'x' << golden.rows << std::endl;
+            cv::imwrite(stem + ".actual.png", image);
+            return 1;
+        }
+
+        std::cout << (result.passed ? "[PASS] " : "[FAIL] ") << goldenPath
+                  << ": max difference " << result.maxDifference
+                  << ", mean " << result.meanDifference
+                  << ", mismatching pixels " << result.mismatchRatio * 100.0 << "%"
+                  << ", SSIM " << result.ssim << std::endl;
+
+        if (!result.passed)
+        {
+            cv::imwrite(stem + ".actual.png", image);
+            cv::imwrite(stem + ".diff.png", result.difference * 8);
+        }
+
+        return result.passed ? 0 : 1;
+    }
+
+private:
+    std::string capturePath;
+    std::string goldenPath;
+    std::string outputDirectory {"."};
+    bool skipMissingGolden {false};
+    int targetFrame {10};
+    ImageTolerance tolerance;
+
+    int frame {0};
+    int exitCode {0};
+};
+
+#endif // LEARNOPENGL_HEADLESS_CAPTURE_H
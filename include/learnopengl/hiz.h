@@ -0,0 +1,585 @@
+#ifndef LEARNOPENGL_HIZ_H
+#define LEARNOPENGL_HIZ_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "learnopengl/camera.h"
+#include "learnopengl/shader.h"
+
+
+// A max-depth pyramid on the CPU, the structure occlusion is tested against.
+//
+// Level 0 holds window-space depth ([0, 1], larger is farther); every further level halves the resolution and keeps
+// the farthest depth of the 2x2 texels below it, so one texel bounds everything behind it. A bounding sphere is
+// hidden if its nearest depth lies behind the farthest depth of every texel its screen rectangle touches, and the
+// level is chosen so that the rectangle touches at most 2x2 texels.
+class DepthPyramid
+{
+public:
+    // level 0 is width x height texels; uvScale maps [0, 1] screen coordinates to level 0 texels and differs from
+    // the size when level 0 is itself a reduction of a larger buffer
+    void resize(int width, int height, const glm::vec2 & uvScale)
+    {
+        // a minimized window reports 0x0, which would never halve down to 1x1
+        width = std::max(1, width);
+        height = std::max(1, height);
+        scale = uvScale;
+
+        if (!sizes.empty() && sizes[0] == glm::ivec2(width, height))
+        {
+            return;
+        }
+
+        sizes.clear();
+        offsets.clear();
+        std::size_t total = 0;
+
+        for (glm::ivec2 size(width, height); ; size = glm::ivec2((size.x + 1) / 2, (size.y + 1) / 2))
+        {
+            sizes.push_back(size);
+            offsets.push_back(total);
+            total += static_cast<std::size_t>(size.x) * size.y;
+
+            if (size.x == 1 && size.y == 1)
+            {
+                break;
+            }
+        }
+
+        texels.resize(total);
+    }
+
+    void resize(int width, int height)
+    {
+        resize(width, height, glm::vec2(width, height));
+    }
+
+    bool empty() const
+    {
+        return sizes.empty();
+    }
+
+    int getWidth() const
+    {
+        return sizes.empty() ? 0 : sizes[0].x;
+    }
+
+    int getHeight() const
+    {
+        return sizes.empty() ? 0 : sizes[0].y;
+    }
+
+    int getLevelCount() const
+    {
+        return static_cast<int>(sizes.size());
+    }
+
+    // row-major texels of a level, bottom row first as in OpenGL
+    float * getLevel(int level)
+    {
+        return texels.data() + offsets[level];
+    }
+
+    const float * getLevel(int level) const
+    {
+        return texels.data() + offsets[level];
+    }
+
+    // derives levels 1.. from level 0
+    void build()
+    {
+        for (std::size_t level = 1; level < sizes.size(); ++level)
+        {
+            const float * src = getLevel(static_cast<int>(level - 1));
+            float * dst = getLevel(static_cast<int>(level));
+            glm::ivec2 srcSize = sizes[level - 1];
+            glm::ivec2 dstSize = sizes[level];
+
+            for (int y = 0; y != dstSize.y; ++y)
+            {
+                // odd sizes: the last texel of a row or column has no partner and is its own maximum
+                const float * row0 = src + static_cast<std::size_t>(2 * y) * srcSize.x;
+                const float * row1 = src + static_cast<std::size_t>(std::min(2 * y + 1, srcSize.y - 1)) * srcSize.x;
+
+                for (int x = 0; x != dstSize.x; ++x)
+                {
+                    int x0 = 2 * x;
+                    int x1 = std::min(2 * x + 1, srcSize.x - 1);
+                    dst[static_cast<std::size_t>(y) * dstSize.x + x] = std::max(std::max(row0[x0], row0[x1]),
+                                                                                std::max(row1[x0], row1[x1]));
+                }
+            }
+        }
+    }
+
+    // true only if the sphere is certainly hidden; view and projection must be the ones the depth was made with.
+    // Spheres reaching through the near plane or off the pyramid's screen count as visible.
+    bool isOccluded(const glm::mat4 & view, const glm::mat4 & projection, const glm::vec3 & center, float radius) const
+    {
+        if (sizes.empty())
+        {
+            return false;
+        }
+
+        glm::vec3 c = glm::vec3(view * glm::vec4(center, 1.0f));
+
+        // nearest depth of the sphere
+        glm::vec4 front = projection * glm::vec4(c.x, c.y, c.z + radius, 1.0f);
+
+        if (front.w <= 0.0f || front.z < -front.w)
+        {
+            return false;
+        }
+
+        float depth = front.z / front.w * 0.5f + 0.5f;
+
+        // screen rectangle of the view-space box around the sphere; every corner is in front of the camera
+        glm::vec2 lo(1.0f);
+        glm::vec2 hi(0.0f);
+
+        for (int i = 0; i != 8; ++i)
+        {
+            glm::vec4 corner(c.x + (i & 1 ? radius : -radius), c.y + (i & 2 ? radius : -radius),
+                             c.z + (i & 4 ? radius : -radius), 1.0f);
+            glm::vec4 clip = projection * corner;
+            glm::vec2 uv = glm::vec2(clip) / clip.w * 0.5f + 0.5f;
+            lo = glm::min(lo, uv);
+            hi = glm::max(hi, uv);
+        }
+
+        if (lo.x < 0.0f || lo.y < 0.0f || hi.x > 1.0f || hi.y > 1.0f)
+        {
+            return false;
+        }
+
+        glm::vec2 texelLo = lo * scale;
+        glm::vec2 texelHi = hi * scale;
+        float extent = std::max(texelHi.x - texelLo.x, texelHi.y - texelLo.y);
+        int level = extent > 1.0f ? static_cast<int>(std::ceil(std::log2(extent))) : 0;
+        level = std::min(level, static_cast<int>(sizes.size()) - 1);
+
+        glm::ivec2 size = sizes[level];
+        const float * texelsOfLevel = getLevel(level);
+        int x0 = std::min(static_cast<int>(texelLo.x) >> level, size.x - 1);
+        int x1 = std::min(static_cast<int>(texelHi.x) >> level, size.x - 1);
+        int y0 = std::min(static_cast<int>(texelLo.y) >> level, size.y - 1);
+        int y1 = std::min(static_cast<int>(texelHi.y) >> level, size.y - 1);
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                if (depth <= texelsOfLevel[static_cast<std::size_t>(y) * size.x + x])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void swap(DepthPyramid & other)
+    {
+        texels.swap(other.texels);
+        sizes.swap(other.sizes);
+        offsets.swap(other.offsets);
+        std::swap(scale, other.scale);
+    }
+
+private:
+    std::vector<float> texels;
+    std::vector<glm::ivec2> sizes;
+    std::vector<std::size_t> offsets;
+    glm::vec2 scale {0.0f};
+};
+
+
+// Rasterizes a few large occluders into a small depth buffer on the CPU; the fallback that needs no GPU readback
+// and has no frame of latency.
+//
+// Only depth is written, conservatively: a triangle writes its farthest vertex depth to the pixels it covers
+// entirely (so pixels split between two triangles of an occluder stay empty), and triangles reaching behind the near
+// plane are skipped. Each can only lose occlusion, never hide something visible.
+class SoftwareOccluder
+{
+public:
+    void begin(int width, int height, const glm::mat4 & viewProjection)
+    {
+        this->viewProjection = viewProjection;
+        pyramid.resize(width, height);
+        std::fill(pyramid.getLevel(0), pyramid.getLevel(0) + static_cast<std::size_t>(width) * height, 1.0f);
+    }
+
+    // indexed triangles in model space
+    void drawTriangles(const glm::mat4 & model, const glm::vec3 * positions, std::size_t vertexCount,
+                       const unsigned int * indices, std::size_t indexCount)
+    {
+        glm::mat4 mvp = viewProjection * model;
+        screen.resize(vertexCount);
+
+        for (std::size_t i = 0; i != vertexCount; ++i)
+        {
+            glm::vec4 clip = mvp * glm::vec4(positions[i], 1.0f);
+
+            // w <= 0 marks a vertex that is behind the near plane
+            screen[i] = clip.z < -clip.w ?
+                        glm::vec4(0.0f) :
+                        glm::vec4((clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(pyramid.getWidth()),
+                                  (clip.y / clip.w * 0.5f + 0.5f) * static_cast<float>(pyramid.getHeight()),
+                                  clip.z / clip.w * 0.5f + 0.5f, clip.w);
+        }
+
+        for (std::size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            const glm::vec4 & a = screen[indices[i]];
+            const glm::vec4 & b = screen[indices[i + 1]];
+            const glm::vec4 & c = screen[indices[i + 2]];
+
+            if (a.w > 0.0f && b.w > 0.0f && c.w > 0.0f)
+            {
+                rasterize(a, b, c);
+            }
+        }
+    }
+
+    // the occluders' depth, with all levels built
+    const DepthPyramid & end()
+    {
+        pyramid.build();
+        return pyramid;
+    }
+
+private:
+    void rasterize(glm::vec4 a, glm::vec4 b, const glm::vec4 & c)
+    {
+        float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+        if (area == 0.0f)
+        {
+            return;
+        }
+
+        // either winding, so closed meshes work with any orientation
+        if (area < 0.0f)
+        {
+            std::swap(a, b);
+        }
+
+        int width = pyramid.getWidth();
+        int height = pyramid.getHeight();
+        int x0 = std::max(static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))), 0);
+        int x1 = std::min(static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))), width - 1);
+        int y0 = std::max(static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))), 0);
+        int y1 = std::min(static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))), height - 1);
+        float depth = std::max({a.z, b.z, c.z});
+        float * texels = pyramid.getLevel(0);
+
+        // an edge function is smallest over a pixel at one of its corners, by this much less than at the center;
+        // requiring the center to clear it by that much covers the whole pixel, not just its center
+        float ab = 0.5f * (std::abs(b.x - a.x) + std::abs(b.y - a.y));
+        float bc = 0.5f * (std::abs(c.x - b.x) + std::abs(c.y - b.y));
+        float ca = 0.5f * (std::abs(a.x - c.x) + std::abs(a.y - c.y));
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            float py = static_cast<float>(y) + 0.5f;
+
+            for (int x = x0; x <= x1; ++x)
+            {
+                float px = static_cast<float>(x) + 0.5f;
+
+                // edge functions at the pixel center
+                if ((b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x) >= ab &&
+                    (c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x) >= bc &&
+                    (a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x) >= ca)
+                {
+                    float & texel = texels[static_cast<std::size_t>(y) * width + x];
+                    texel = std::min(texel, depth);
+                }
+            }
+        }
+    }
+
+private:
+    DepthPyramid pyramid;
+    glm::mat4 viewProjection {1.0f};
+    std::vector<glm::vec4> screen;
+};
+
+
+// Builds the depth pyramid of a rendered frame on the GPU and reads it back without stalling.
+//
+// Each pass of the reduction shader draws one level, taking the maximum of 2x2 texels of the level before (the
+// depth buffer for the first pass, so pyramid level 0 is at half resolution). The first level not wider than
+// readbackWidth is then copied into a pixel pack buffer behind a fence; fetch() hands out the newest copy the GPU
+// has finished, usually that of the previous frame, so culling runs against last frame's depth.
+class HiZBuffer
+{
+public:
+    explicit HiZBuffer(int readbackWidth = 160) : readbackWidth(readbackWidth)
+    {
+        glGenFramebuffers(1, &fbo);
+        glGenTextures(1, &pyramidTexture);
+        glGenVertexArrays(1, &emptyVertexArray);
+
+        for (Readback & readback : readbacks)
+        {
+            glGenBuffers(1, &readback.pbo);
+        }
+    }
+
+    HiZBuffer(const HiZBuffer &) = delete;
+
+    HiZBuffer & operator=(const HiZBuffer &) = delete;
+
+    ~HiZBuffer()
+    {
+        for (Readback & readback : readbacks)
+        {
+            if (readback.fence)
+            {
+                glDeleteSync(readback.fence);
+            }
+
+            glDeleteBuffers(1, &readback.pbo);
+        }
+
+        glDeleteVertexArrays(1, &emptyVertexArray);
+        glDeleteTextures(1, &pyramidTexture);
+        glDeleteFramebuffers(1, &fbo);
+    }
+
+    // reduces depthTexture (width x height, nearest filtering, no compare mode) into the pyramid and starts the
+    // readback; uniforms are the generated uniforms of reduceShader (HiZUniforms), view and projection are the
+    // matrices the depth was rendered with. Leaves framebuffer 0 bound.
+    template <typename ReduceUniforms>
+    void build(Shader & reduceShader, const ReduceUniforms & uniforms, unsigned int depthTexture, int width,
+               int height, const glm::mat4 & view, const glm::mat4 & projection)
+    {
+        if (levelSizes.empty() || sourceSize != glm::ivec2(width, height))
+        {
+            allocate(width, height);
+        }
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glBindVertexArray(emptyVertexArray);
+        glActiveTexture(GL_TEXTURE0);
+
+        reduceShader.use();
+        uniforms.source.set({0});
+
+        for (std::size_t level = 0; level != levelSizes.size(); ++level)
+        {
+            if (level == 0)
+            {
+                glBindTexture(GL_TEXTURE_2D, depthTexture);
+            }
+            else
+            {
+                // only the level read from is visible to the shader, so reading and writing one texture is defined
+                glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<int>(level) - 1);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(level) - 1);
+            }
+
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pyramidTexture,
+                                   static_cast<int>(level));
+            glViewport(0, 0, levelSizes[level].x, levelSizes[level].y);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(levelSizes.size()) - 1);
+
+        // a slot the CPU never fetched is stale by now and simply reused
+        Readback & readback = readbacks[issued % kReadbackCount];
+
+        if (readback.fence)
+        {
+            glDeleteSync(readback.fence);
+        }
+
+        glm::ivec2 size = levelSizes[readbackLevel];
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pyramidTexture, readbackLevel);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+
+        if (readback.size != size)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size.x) * size.y * sizeof(float), nullptr,
+                         GL_STREAM_READ);
+        }
+
+        glReadPixels(0, 0, size.x, size.y, GL_RED, GL_FLOAT, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        readback.issue = ++issued;
+        readback.size = size;
+        readback.uvScale = glm::vec2(sourceSize) / static_cast<float>(2 << readbackLevel);
+        readback.view = view;
+        readback.projection = projection;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindVertexArray(0);
+
+        if (depthTest)
+        {
+            glEnable(GL_DEPTH_TEST);
+        }
+    }
+
+    // copies the newest finished readback into pyramid, with the matrices to test it with; false if none finished
+    // since the last call. Never waits for the GPU.
+    bool fetch(DepthPyramid & pyramid, glm::mat4 & view, glm::mat4 & projection)
+    {
+        Readback * newest = nullptr;
+
+        for (Readback & readback : readbacks)
+        {
+            if (!readback.fence || (newest && newest->issue > readback.issue))
+            {
+                continue;
+            }
+
+            GLenum status = glClientWaitSync(readback.fence, 0, 0);
+
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+            {
+                newest = &readback;
+            }
+        }
+
+        if (!newest)
+        {
+            return false;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, newest->pbo);
+        auto * texels = static_cast<const float *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+        if (texels)
+        {
+            pyramid.resize(newest->size.x, newest->size.y, newest->uvScale);
+            std::memcpy(pyramid.getLevel(0), texels, static_cast<std::size_t>(newest->size.x) * newest->size.y *
+                                                     sizeof(float));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            pyramid.build();
+
+            view = newest->view;
+            projection = newest->projection;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // this and every older readback are consumed
+        for (Readback & readback : readbacks)
+        {
+            if (readback.fence && readback.issue <= newest->issue)
+            {
+                glDeleteSync(readback.fence);
+                readback.fence = nullptr;
+            }
+        }
+
+        return texels != nullptr;
+    }
+
+    // the R32F pyramid with all levels, e.g. for GPU-side tests
+    unsigned int getTexture() const
+    {
+        return pyramidTexture;
+    }
+
+private:
+    static constexpr int kReadbackCount = 3;
+
+    struct Readback
+    {
+        unsigned int pbo {0};
+        GLsync fence {nullptr};
+        unsigned long long issue {0};
+        glm::ivec2 size {0};
+        glm::vec2 uvScale {0.0f};
+        glm::mat4 view {1.0f};
+        glm::mat4 projection {1.0f};
+    };
+
+    void allocate(int width, int height)
+    {
+        sourceSize = glm::ivec2(width, height);
+        levelSizes.clear();
+
+        // a minimized window reports 0x0, which would never halve down to 1x1
+        for (glm::ivec2 size(std::max(1, (width + 1) / 2), std::max(1, (height + 1) / 2)); ;
+             size = glm::ivec2((size.x + 1) / 2, (size.y + 1) / 2))
+        {
+            levelSizes.push_back(size);
+
+            if (size.x == 1 && size.y == 1)
+            {
+                break;
+            }
+        }
+
+        glBindTexture(GL_TEXTURE_2D, pyramidTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        for (std::size_t level = 0; level != levelSizes.size(); ++level)
+        {
+            glTexImage2D(GL_TEXTURE_2D, static_cast<int>(level), GL_R32F, levelSizes[level].x, levelSizes[level].y, 0,
+                         GL_RED, GL_FLOAT, nullptr);
+        }
+
+        readbackLevel = 0;
+
+        while (levelSizes[readbackLevel].x > readbackWidth && readbackLevel + 1 < static_cast<int>(levelSizes.size()))
+        {
+            ++readbackLevel;
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pyramidTexture, 0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Depth pyramid framebuffer is not complete!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+    }
+
+private:
+    int readbackWidth;
+    int readbackLevel {0};
+    glm::ivec2 sourceSize {0};
+    std::vector<glm::ivec2> levelSizes;
+
+    unsigned int fbo {0};
+    unsigned int pyramidTexture {0};
+    unsigned int emptyVertexArray {0};
+
+    Readback readbacks[kReadbackCount];
+    unsigned long long issued {0};
+};
+
+#endif // LEARNOPENGL_HIZ_H
@@ -0,0 +1,139 @@
+#ifndef LEARNOPENGL_IMAGE_COMPARE_H
+#define LEARNOPENGL_IMAGE_COMPARE_H
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+
+// how far a rendered image may drift from its golden image: drivers differ in rasterization and filtering details,
+// so exact equality is too strict, while a few broken pixels or a shifted structure must still fail
+struct ImageTolerance
+{
+    int channelTolerance {8};           // per-channel difference up to which a pixel still matches
+    double maxMismatchRatio {0.001};    // share of pixels allowed to exceed channelTolerance
+    double minSsim {0.98};              // mean structural similarity of the luminance
+};
+
+
+struct ImageComparison
+{
+    bool sizeMatches;
+    int maxDifference;                  // largest per-channel difference
+    double meanDifference;              // mean per-channel difference
+    double mismatchRatio;               // share of pixels beyond the channel tolerance
+    double ssim;
+    bool passed;
+    cv::Mat difference;                 // 8-bit, the largest channel difference per pixel, for inspection
+};
+
+
+// Compares 8-bit BGR images as loaded by cv::imread, by a per-pixel tolerance and by SSIM.
+class ImageCompare
+{
+public:
+    static ImageComparison compare(const cv::Mat & actual, const cv::Mat & expected,
+                                   const ImageTolerance & tolerance = ImageTolerance())
+    {
+        ImageComparison result {};
+        result.sizeMatches = actual.size() == expected.size() && actual.type() == expected.type();
+
+        if (!result.sizeMatches || actual.empty())
+        {
+            return result;
+        }
+
+        cv::Mat absolute;
+        cv::absdiff(actual, expected, absolute);
+
+        std::vector<cv::Mat> channels;
+        cv::split(absolute, channels);
+        result.difference = channels[0].clone();
+
+        for (std::size_t c = 1; c < channels.size(); ++c)
+        {
+            result.difference = cv::max(result.difference, channels[c]);
+        }
+
+        double maxDifference = 0.0;
+        cv::minMaxLoc(result.difference, nullptr, &maxDifference);
+        result.maxDifference = static_cast<int>(maxDifference);
+
+        cv::Scalar mean = cv::mean(absolute);
+        result.meanDifference = 0.0;
+
+        for (int c = 0; c < absolute.channels(); ++c)
+        {
+            result.meanDifference += mean[c] / absolute.channels();
+        }
+
+        result.mismatchRatio = static_cast<double>(cv::countNonZero(result.difference > tolerance.channelTolerance)) /
+                               static_cast<double>(result.difference.total());
+        result.ssim = ssim(actual, expected);
+        result.passed = result.mismatchRatio <= tolerance.maxMismatchRatio && result.ssim >= tolerance.minSsim;
+
+        return result;
+    }
+
+    // mean SSIM of the luminance (Wang et al. 2004: 11x11 Gaussian window, sigma 1.5, K1 0.01, K2 0.03)
+    static double ssim(const cv::Mat & a, const cv::Mat & b)
+    {
+        cv::Mat x = luminance(a);
+        cv::Mat y = luminance(b);
+
+        const double c1 = (0.01 * 255.0) * (0.01 * 255.0);
+        const double c2 = (0.03 * 255.0) * (0.03 * 255.0);
+        const cv::Size window(11, 11);
+        const double sigma = 1.5;
+
+        cv::Mat muX;
+        cv::Mat muY;
+        cv::GaussianBlur(x, muX, window, sigma);
+        cv::GaussianBlur(y, muY, window, sigma);
+
+        cv::Mat muXX = muX.mul(muX);
+        cv::Mat muYY = muY.mul(muY);
+        cv::Mat muXY = muX.mul(muY);
+
+        cv::Mat sigmaXX;
+        cv::Mat sigmaYY;
+        cv::Mat sigmaXY;
+        cv::GaussianBlur(x.mul(x), sigmaXX, window, sigma);
+        cv::GaussianBlur(y.mul(y), sigmaYY, window, sigma);
+        cv::GaussianBlur(x.mul(y), sigmaXY, window, sigma);
+        sigmaXX -= muXX;
+        sigmaYY -= muYY;
+        sigmaXY -= muXY;
+
+        cv::Mat numerator = (2.0 * muXY + c1).mul(2.0 * sigmaXY + c2);
+        cv::Mat denominator = (muXX + muYY + c1).mul(sigmaXX + sigmaYY + c2);
+        cv::Mat map;
+        cv::divide(numerator, denominator, map);
+
+        return cv::mean(map)[0];
+    }
+
+private:
+    static cv::Mat luminance(const cv::Mat & image)
+    {
+        cv::Mat gray;
+
+        if (image.channels() == 1)
+        {
+            gray = image;
+        }
+        else
+        {
+            cv::cvtColor(image, gray, image.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        }
+
+        cv::Mat result;
+        gray.convertTo(result, CV_64F);
+
+        return result;
+    }
+};
+
+#endif // LEARNOPENGL_IMAGE_COMPARE_H
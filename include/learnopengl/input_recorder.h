@@ -0,0 +1,333 @@
+#ifndef LEARNOPENGL_INPUT_RECORDER_H
+#define LEARNOPENGL_INPUT_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+
+enum class InputEventType : std::uint8_t
+{
+    KeyDown,
+    KeyUp,
+    MouseMove,      // x, y: the offsets the camera was given
+    Scroll,         // y: the scroll offset
+    End             // when recording stopped
+};
+
+
+struct InputEvent
+{
+    double time;    // seconds since recording started, on the clock the recorder passes (10_camera: simulation time)
+    InputEventType type;
+    int key;
+    float x;
+    float y;
+};
+
+
+// The input of a session as a list of timestamped events, saved as a compact binary log.
+//
+// File layout, little endian: the magic "LOIN", a u32 version, the f64 fixed step in seconds the input was applied
+// at, then per event a u8 type, a u32 count of microseconds since the previous event and the payload: a u16 key for
+// KeyDown/KeyUp, two f32 for MouseMove, one f32 for Scroll. Key state is logged as transitions, so a held key costs
+// nothing per frame.
+class InputLog
+{
+public:
+    // time is the clock reading at which the session starts; later calls pass readings of the same clock.
+    // step is the fixed update step the input is applied at, which a replay must use to reproduce the session.
+    void begin(double time, double step)
+    {
+        origin = time;
+        this->step = step;
+        events.clear();
+        keys.clear();
+    }
+
+    // the key's current state, logged when it changed
+    void setKey(double time, int key, bool down)
+    {
+        if (down == (keys.count(key) != 0))
+        {
+            return;
+        }
+
+        if (down)
+        {
+            keys.insert(key);
+        }
+        else
+        {
+            keys.erase(key);
+        }
+
+        events.push_back({time - origin, down ? InputEventType::KeyDown : InputEventType::KeyUp, key, 0.0f, 0.0f});
+    }
+
+    void mouseMove(double time, float xoffset, float yoffset)
+    {
+        events.push_back({time - origin, InputEventType::MouseMove, 0, xoffset, yoffset});
+    }
+
+    void scroll(double time, float yoffset)
+    {
+        events.push_back({time - origin, InputEventType::Scroll, 0, 0.0f, yoffset});
+    }
+
+    // appends the End event at the given time and writes the log
+    void save(const std::string & path, double time)
+    {
+        events.push_back({time - origin, InputEventType::End, 0, 0.0f, 0.0f});
+
+        std::ofstream fout {path, std::ofstream::out | std::ofstream::binary};
+        fout.write(kMagic, 4);
+        put<std::uint32_t>(fout, kVersion);
+        put<double>(fout, step);
+
+        std::uint64_t last = 0;
+
+        for (const InputEvent & event : events)
+        {
+            // quantized against the previous quantized time, so rounding does not accumulate
+            auto now = static_cast<std::uint64_t>(event.time * 1e6 + 0.5);
+            now = now < last ? last : now;
+
+            put<std::uint8_t>(fout, static_cast<std::uint8_t>(event.type));
+            put<std::uint32_t>(fout, static_cast<std::uint32_t>(now - last));
+            last = now;
+
+            switch (event.type)
+            {
+                case InputEventType::KeyDown:
+                case InputEventType::KeyUp:
+                    put<std::uint16_t>(fout, static_cast<std::uint16_t>(event.key));
+                    break;
+                case InputEventType::MouseMove:
+                    put<float>(fout, event.x);
+                    put<float>(fout, event.y);
+                    break;
+                case InputEventType::Scroll:
+                    put<float>(fout, event.y);
+                    break;
+                case InputEventType::End:
+                    break;
+            }
+        }
+
+        if (!fout)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Failed to write input log " << path
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+    }
+
+    // replaces the events by those of a saved log, with times quantized to microseconds
+    void load(const std::string & path)
+    {
+        std::ifstream fin {path, std::ifstream::in | std::ifstream::binary};
+        char magic[4] {};
+        fin.read(magic, 4);
+
+        if (!fin || std::string(magic, 4) != std::string(kMagic, 4) || get<std::uint32_t>(fin) != kVersion)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << path << " is not an input log"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        step = get<double>(fin);
+
+        if (!fin || !(step > 0.0))
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << path << " has no valid fixed step"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        events.clear();
+        std::uint64_t micros = 0;
+
+        while (true)
+        {
+            auto typeByte = get<std::uint8_t>(fin);
+            micros += get<std::uint32_t>(fin);
+
+            if (!fin)
+            {
+                break;
+            }
+
+            if (typeByte > static_cast<std::uint8_t>(InputEventType::End))
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << path << " has an event of unknown type " << static_cast<int>(typeByte)
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+
+            auto type = static_cast<InputEventType>(typeByte);
+            InputEvent event {static_cast<double>(micros) * 1e-6, type, 0, 0.0f, 0.0f};
+
+            switch (type)
+            {
+                case InputEventType::KeyDown:
+                case InputEventType::KeyUp:
+                    event.key = get<std::uint16_t>(fin);
+                    break;
+                case InputEventType::MouseMove:
+                    event.x = get<float>(fin);
+                    event.y = get<float>(fin);
+                    break;
+                case InputEventType::Scroll:
+                    event.y = get<float>(fin);
+                    break;
+                case InputEventType::End:
+                    break;
+            }
+
+            events.push_back(event);
+
+            if (type == InputEventType::End)
+            {
+                break;
+            }
+        }
+
+        // a log cut short still replays up to its last event
+        if (events.empty() || events.back().type != InputEventType::End)
+        {
+            events.push_back({events.empty() ? 0.0 : events.back().time, InputEventType::End, 0, 0.0f, 0.0f});
+        }
+    }
+
+    const std::vector<InputEvent> & getEvents() const
+    {
+        return events;
+    }
+
+    // the fixed step passed to begin(), or read by load()
+    double getStep() const
+    {
+        return step;
+    }
+
+private:
+    template <typename T>
+    static void put(std::ofstream & fout, T value)
+    {
+        fout.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static T get(std::ifstream & fin)
+    {
+        T value {};
+        fin.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr const char * kMagic = "LOIN";
+    static constexpr std::uint32_t kVersion = 2;
+
+    double origin {0.0};
+    double step {0.0};
+    std::vector<InputEvent> events;
+    std::unordered_set<int> keys;
+};
+
+
+// Plays an InputLog back in the fixed step it was recorded at, independent of the frame rate.
+//
+// Each advance() moves the replay clock by one step and hands the mouse and scroll events up to it to the callback,
+// in order; key events only update isKeyDown(), which the caller applies for a whole step. With the same log, every
+// run feeds the camera the identical sequence of calls.
+class InputReplay
+{
+public:
+    explicit InputReplay(const InputLog & log) : events(log.getEvents()), step(log.getStep())
+    {
+    }
+
+    // returns false, without calling apply, once the log has ended
+    template <typename Apply>
+    bool advance(Apply && apply)
+    {
+        if (ended)
+        {
+            return false;
+        }
+
+        ++steps;
+        double time = static_cast<double>(steps) * step;
+
+        while (next != events.size() && events[next].time <= time)
+        {
+            const InputEvent & event = events[next++];
+
+            switch (event.type)
+            {
+                case InputEventType::KeyDown:
+                    keys.insert(event.key);
+                    break;
+                case InputEventType::KeyUp:
+                    keys.erase(event.key);
+                    break;
+                case InputEventType::MouseMove:
+                case InputEventType::Scroll:
+                    apply(event);
+                    break;
+                case InputEventType::End:
+                    ended = true;
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool isKeyDown(int key) const
+    {
+        return keys.count(key) != 0;
+    }
+
+    double getStep() const
+    {
+        return step;
+    }
+
+    // steps advanced so far, including the one that reached the end
+    unsigned long long getSteps() const
+    {
+        return steps;
+    }
+
+private:
+    const std::vector<InputEvent> & events;
+    double step;
+
+    std::size_t next {0};
+    unsigned long long steps {0};
+    bool ended {false};
+    std::unordered_set<int> keys;
+};
+
+#endif // LEARNOPENGL_INPUT_RECORDER_H
@@ -0,0 +1,476 @@
+#ifndef LEARNOPENGL_JOB_SYSTEM_H
+#define LEARNOPENGL_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Counts the outstanding jobs of a group; wait() on it returns once all of them have run.
+class JobCounter
+{
+public:
+    bool isDone() const
+    {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending {0};
+};
+
+
+// A void() callable stored inline, so queueing a job never touches the heap. The callable (for a lambda, its
+// captures) must fit kSize bytes; capture large state by reference.
+class JobFunction
+{
+public:
+    static constexpr std::size_t kSize = 64;
+
+    JobFunction() = default;
+
+    template <typename Function,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Function>, JobFunction>::value>>
+    JobFunction(Function && function)
+    {
+        using Stored = std::decay_t<Function>;
+        static_assert(sizeof(Stored) <= kSize, "the job does not fit JobFunction::kSize, capture by reference");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "the job is over-aligned");
+        static_assert(std::is_nothrow_move_constructible<Stored>::value, "the job must be nothrow movable");
+
+        new (storage) Stored(std::forward<Function>(function));
+        operations = &operationsOf<Stored>;
+    }
+
+    JobFunction(JobFunction && other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    JobFunction & operator=(JobFunction && other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    JobFunction(const JobFunction &) = delete;
+
+    JobFunction & operator=(const JobFunction &) = delete;
+
+    ~JobFunction()
+    {
+        reset();
+    }
+
+    explicit operator bool() const
+    {
+        return operations != nullptr;
+    }
+
+    void operator()()
+    {
+        operations->invoke(storage);
+    }
+
+private:
+    struct Operations
+    {
+        void (* invoke)(void * callable);
+        void (* move)(void * from, void * to);  // move-constructs into to and destroys from
+        void (* destroy)(void * callable);
+    };
+
+    template <typename Stored>
+    static constexpr Operations operationsOf
+    {
+        [](void * callable) { (*static_cast<Stored *>(callable))(); },
+        [](void * from, void * to)
+        {
+            new (to) Stored(std::move(*static_cast<Stored *>(from)));
+            static_cast<Stored *>(from)->~Stored();
+        },
+        [](void * callable) { static_cast<Stored *>(callable)->~Stored(); }
+    };
+
+    void moveFrom(JobFunction & other)
+    {
+        if (other.operations)
+        {
+            other.operations->move(other.storage, storage);
+            operations = other.operations;
+            other.operations = nullptr;
+        }
+    }
+
+    void reset()
+    {
+        if (operations)
+        {
+            operations->destroy(storage);
+            operations = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[kSize];
+    const Operations * operations {nullptr};
+};
+
+
+// A work-stealing task scheduler for per-frame CPU work.
+//
+// Every worker, and the thread that created the system, owns a deque: it pushes and pops its own jobs at the back
+// (most recent first, cache-warm), while idle workers steal from the front of other deques (oldest, and therefore
+// the largest pieces of a recursively split range). A thread that waits on a counter keeps executing jobs instead of
+// sleeping, so jobs may submit and wait on nested jobs without deadlocking the pool.
+//
+// Only the creating thread and the workers may submit and wait. Each thread keeps its index per system, so a thread
+// may belong to several systems, e.g. create one inside a job of another.
+//
+// Jobs are stored inline (JobFunction) in fixed-size ring buffers, so submitting does not allocate once the system
+// is constructed. A job submitted to a full deque runs immediately on the submitting thread.
+class JobSystem
+{
+public:
+    using Job = JobFunction;
+
+    // called on every thread of the system with its thread index before it runs any job
+    using ThreadStartCallback = std::function<void(unsigned int index)>;
+
+    // jobs a deque holds before submit() runs them in place
+    static constexpr std::size_t kQueueCapacity = 1024;
+
+    // one worker per hardware thread besides the calling one
+    static unsigned int getDefaultThreadCount()
+    {
+        return std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    // threadCount workers in addition to the calling thread
+    explicit JobSystem(unsigned int threadCount = getDefaultThreadCount(),
+                       ThreadStartCallback threadStart = nullptr) :
+            threadStart(std::move(threadStart))
+    {
+        queues.reserve(threadCount + 1);
+
+        for (unsigned int i = 0; i != threadCount + 1; ++i)
+        {
+            queues.push_back(std::make_unique<Queue>());
+        }
+
+        // the creating thread is queue 0
+        memberships().emplace_back(id, 0);
+
+        if (this->threadStart)
+        {
+            this->threadStart(0);
+        }
+
+        workers.reserve(threadCount);
+
+        for (unsigned int i = 0; i != threadCount; ++i)
+        {
+            workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+        }
+    }
+
+    JobSystem(const JobSystem &) = delete;
+
+    JobSystem & operator=(const JobSystem &) = delete;
+
+    ~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            running = false;
+        }
+
+        sleepCondition.notify_all();
+
+        for (std::thread & worker : workers)
+        {
+            worker.join();
+        }
+
+        auto & calling = memberships();
+        calling.erase(std::remove_if(calling.begin(), calling.end(), [this](const Membership & membership)
+        {
+            return membership.first == id;
+        }), calling.end());
+    }
+
+    // number of threads executing jobs, including the one that created the system
+    unsigned int getThreadCount() const
+    {
+        return static_cast<unsigned int>(queues.size());
+    }
+
+    // index of the calling thread within this system: 0 for the creating thread, 1.. for the workers; e.g. to pick
+    // a per-thread buffer inside a job. Like submit() and wait(), it aborts on any other thread.
+    unsigned int getThreadIndex() const
+    {
+        for (const Membership & membership : memberships())
+        {
+            if (membership.first == id)
+            {
+                return membership.second;
+            }
+        }
+
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "The calling thread neither created this JobSystem nor is one of its workers!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // queues a job on the calling thread's deque; counter, if given, is decremented once the job has run
+    void submit(Job job, JobCounter * counter = nullptr)
+    {
+        if (counter)
+        {
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Queue & queue = *queues[getThreadIndex()];
+
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.count != kQueueCapacity)
+            {
+                Task & task = queue.tasks[(queue.first + queue.count++) % kQueueCapacity];
+                task.job = std::move(job);
+                task.counter = counter;
+            }
+        }
+
+        if (job)
+        {
+            // the deque is full
+            run(job, counter);
+            return;
+        }
+
+        {
+            // under the sleep mutex, so a worker cannot miss the job between its check and going to sleep
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queuedJobs.fetch_add(1, std::memory_order_release);
+        }
+
+        sleepCondition.notify_one();
+    }
+
+    // runs jobs (of any group) until every job counted by counter has finished
+    void wait(const JobCounter & counter)
+    {
+        while (!counter.isDone())
+        {
+            if (!runOne(getThreadIndex()))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // calls body(first, last) over [begin, end) in ranges of at most grainSize elements and returns when all are done
+    template <typename Body>
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, const Body & body)
+    {
+        JobCounter counter;
+        splitRange(begin, end, std::max<std::size_t>(1, grainSize), body, counter);
+        wait(counter);
+    }
+
+    // parallelFor with a grain size that gives every thread a few ranges to balance with
+    template <typename Body>
+    void parallelFor(std::size_t begin, std::size_t end, const Body & body)
+    {
+        std::size_t ranges = 4 * static_cast<std::size_t>(getThreadCount());
+        parallelFor(begin, end, (end - begin + ranges - 1) / ranges, body);
+    }
+
+private:
+    struct Task
+    {
+        Job job;
+        JobCounter * counter {nullptr};
+    };
+
+    // a ring buffer of tasks, oldest at first
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Task> tasks {kQueueCapacity};
+        std::size_t first {0};
+        std::size_t count {0};
+    };
+
+    // a system's id and the thread's index in it
+    using Membership = std::pair<std::uint64_t, unsigned int>;
+
+    // the systems the calling thread belongs to; by id rather than address, which a later system may reuse
+    static std::vector<Membership> & memberships()
+    {
+        thread_local std::vector<Membership> systems;
+        return systems;
+    }
+
+    static std::uint64_t nextId()
+    {
+        static std::atomic<std::uint64_t> next {0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // halves the range, queueing the upper half for thieves, until it is small enough to run here
+    template <typename Body>
+    void splitRange(std::size_t begin, std::size_t end, std::size_t grainSize, const Body & body, JobCounter & counter)
+    {
+        while (end - begin > grainSize)
+        {
+            std::size_t middle = begin + (end - begin) / 2;
+
+            submit([this, middle, end, grainSize, &body, &counter]
+                   {
+                       splitRange(middle, end, grainSize, body, counter);
+                   }, &counter);
+
+            end = middle;
+        }
+
+        if (begin != end)
+        {
+            body(begin, end);
+        }
+    }
+
+    // pops from the own deque, else steals from the others; false if there was nothing to do
+    bool runOne(unsigned int self)
+    {
+        Task task;
+
+        if (!pop(self, task))
+        {
+            bool stolen = false;
+
+            for (std::size_t i = 1; i != queues.size() && !stolen; ++i)
+            {
+                stolen = steal((self + i) % queues.size(), task);
+            }
+
+            if (!stolen)
+            {
+                return false;
+            }
+        }
+
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        run(task.job, task.counter);
+
+        return true;
+    }
+
+    static void run(Job & job, JobCounter * counter)
+    {
+        job();
+
+        if (counter)
+        {
+            counter->pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    bool pop(unsigned int index, Task & task)
+    {
+        Queue & queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.count == 0)
+        {
+            return false;
+        }
+
+        task = std::move(queue.tasks[(queue.first + --queue.count) % kQueueCapacity]);
+
+        return true;
+    }
+
+    bool steal(std::size_t index, Task & task)
+    {
+        Queue & queue = *queues[index];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+
+        if (!lock.owns_lock() || queue.count == 0)
+        {
+            return false;
+        }
+
+        task = std::move(queue.tasks[queue.first]);
+        queue.first = (queue.first + 1) % kQueueCapacity;
+        --queue.count;
+
+        return true;
+    }
+
+    void workerLoop(unsigned int index)
+    {
+        memberships().emplace_back(id, index);
+
+        if (threadStart)
+        {
+            threadStart(index);
+        }
+
+        while (true)
+        {
+            if (runOne(index))
+            {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this]
+            {
+                return !running || queuedJobs.load(std::memory_order_acquire) > 0;
+            });
+
+            if (!running)
+            {
+                break;
+            }
+        }
+    }
+
+private:
+    const std::uint64_t id {nextId()};
+    ThreadStartCallback threadStart;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    // idle workers sleep until a job is queued
+    std::atomic<int> queuedJobs {0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool running {true};
+};
+
+#endif // LEARNOPENGL_JOB_SYSTEM_H
@@ -0,0 +1,399 @@
+#ifndef LEARNOPENGL_MESH_H
+#define LEARNOPENGL_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "learnopengl/mesh_simplifier.h"
+
+
+// one level of detail: a range of the shared index buffer and its geometric error in object space
+struct MeshLod
+{
+    std::uint32_t firstIndex;
+    std::uint32_t indexCount;
+    float error;
+};
+
+
+// An indexed triangle mesh with its LOD chain, as imported and as stored on disk.
+//
+// The ".lodmesh" file is a MeshFileHeader followed by the vertices, the indices of all levels back to back and one
+// MeshLod per level, finest first. Levels share the vertex buffer, so switching levels only changes the index range.
+class MeshData
+{
+public:
+    struct MeshFileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t vertexCount;
+        std::uint32_t indexCount;
+        std::uint32_t lodCount;
+        float radius;           // bounding sphere around the origin
+    };
+
+public:
+    // positions and texture coordinates of a Wavefront OBJ file; polygons are triangulated as fans
+    static bool importObj(const char * path, MeshData & mesh)
+    {
+        std::ifstream fin {path, std::ifstream::in};
+
+        if (!fin)
+        {
+            return false;
+        }
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::map<std::pair<int, int>, unsigned int> vertexOf;
+        mesh = MeshData();
+
+        // a vertex per distinct position/texture coordinate pair
+        auto vertex = [&](const std::string & corner) -> unsigned int
+        {
+            int p = 0;
+            int t = 0;
+            std::sscanf(corner.c_str(), "%d/%d", &p, &t);
+            p = p < 0 ? static_cast<int>(positions.size()) + p : p - 1;
+            t = t < 0 ? static_cast<int>(texCoords.size()) + t : t - 1;
+
+            if (p < 0 || p >= static_cast<int>(positions.size()))
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << path << ": face corner \"" << corner << "\" refers to no position"
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+
+            auto inserted = vertexOf.emplace(std::make_pair(p, t), static_cast<unsigned int>(mesh.vertices.size()));
+
+            if (inserted.second)
+            {
+                MeshVertex v {};
+                v.position = positions[p];
+                v.texCoord = 0 <= t && t < static_cast<int>(texCoords.size()) ? texCoords[t] : glm::vec2(0.0f);
+                mesh.vertices.push_back(v);
+            }
+
+            return inserted.first->second;
+        };
+
+        std::string line;
+
+        while (std::getline(fin, line))
+        {
+            std::istringstream words(line);
+            std::string type;
+            words >> type;
+
+            if (type == "v")
+            {
+                glm::vec3 p;
+                words >> p.x >> p.y >> p.z;
+                positions.push_back(p);
+            }
+            else if (type == "vt")
+            {
+                glm::vec2 t;
+                words >> t.x >> t.y;
+                texCoords.push_back(t);
+            }
+            else if (type == "f")
+            {
+                std::vector<unsigned int> polygon;
+                std::string corner;
+
+                while (words >> corner)
+                {
+                    polygon.push_back(vertex(corner));
+                }
+
+                for (std::size_t i = 2; i < polygon.size(); ++i)
+                {
+                    mesh.indices.insert(mesh.indices.end(), {polygon[0], polygon[i - 1], polygon[i]});
+                }
+            }
+        }
+
+        mesh.lods = {{0, static_cast<std::uint32_t>(mesh.indices.size()), 0.0f}};
+
+        return !mesh.indices.empty();
+    }
+
+    // unit UV sphere, the default mesh of the LOD sample
+    static MeshData sphere(int segments = 96, int rings = 48)
+    {
+        MeshData mesh;
+
+        for (int r = 0; r <= rings; ++r)
+        {
+            float theta = glm::pi<float>() * static_cast<float>(r) / static_cast<float>(rings);
+
+            for (int s = 0; s <= segments; ++s)
+            {
+                float phi = 2.0f * glm::pi<float>() * static_cast<float>(s) / static_cast<float>(segments);
+
+                MeshVertex v {};
+                v.position = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta),
+                                       std::sin(theta) * std::sin(phi));
+                v.texCoord = glm::vec2(2.0f * static_cast<float>(s) / static_cast<float>(segments),
+                                       static_cast<float>(r) / static_cast<float>(rings));
+                mesh.vertices.push_back(v);
+            }
+        }
+
+        for (int r = 0; r != rings; ++r)
+        {
+            for (int s = 0; s != segments; ++s)
+            {
+                unsigned int i0 = r * (segments + 1) + s;
+                unsigned int i1 = i0 + segments + 1;
+
+                if (r != 0)
+                {
+                    mesh.indices.insert(mesh.indices.end(), {i0, i0 + 1, i1});
+                }
+
+                if (r != rings - 1)
+                {
+                    mesh.indices.insert(mesh.indices.end(), {i0 + 1, i1 + 1, i1});
+                }
+            }
+        }
+
+        mesh.lods = {{0, static_cast<std::uint32_t>(mesh.indices.size()), 0.0f}};
+
+        return mesh;
+    }
+
+    // replaces the chain below level 0 by up to maxLevels levels, each with about ratio times the previous triangles
+    void buildLods(int maxLevels = 6, float ratio = 0.5f)
+    {
+        std::vector<unsigned int> current(indices.begin(), indices.begin() + lods.at(0).indexCount);
+        indices = current;
+        lods = {{0, static_cast<std::uint32_t>(current.size()), 0.0f}};
+
+        for (int level = 1; level < maxLevels; ++level)
+        {
+            auto target = static_cast<std::size_t>(static_cast<float>(current.size()) * ratio) / 3 * 3;
+            float error = 0.0f;
+            std::vector<unsigned int> simplified = MeshSimplifier::simplify(vertices, current, target, error);
+
+            // stop once the constraints keep the simplifier from making real progress
+            if (simplified.size() > current.size() * 9 / 10 || simplified.empty())
+            {
+                break;
+            }
+
+            // errors accumulate along the chain
+            error += lods.back().error;
+            lods.push_back({static_cast<std::uint32_t>(indices.size()), static_cast<std::uint32_t>(simplified.size()),
+                            error});
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+            current.swap(simplified);
+        }
+    }
+
+    float getRadius() const
+    {
+        float radius = 0.0f;
+
+        for (const MeshVertex & v : vertices)
+        {
+            radius = std::max(radius, glm::length(v.position));
+        }
+
+        return radius;
+    }
+
+    bool save(const char * path) const
+    {
+        std::ofstream fout {path, std::ofstream::out | std::ofstream::binary};
+
+        if (!fout)
+        {
+            return false;
+        }
+
+        MeshFileHeader header {};
+        std::memcpy(header.magic, "LODM", 4);
+        header.version = 1;
+        header.vertexCount = static_cast<std::uint32_t>(vertices.size());
+        header.indexCount = static_cast<std::uint32_t>(indices.size());
+        header.lodCount = static_cast<std::uint32_t>(lods.size());
+        header.radius = getRadius();
+
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(MeshFileHeader));
+        fout.write(reinterpret_cast<const char *>(vertices.data()), vertices.size() * sizeof(MeshVertex));
+        fout.write(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(unsigned int));
+        fout.write(reinterpret_cast<const char *>(lods.data()), lods.size() * sizeof(MeshLod));
+
+        return static_cast<bool>(fout);
+    }
+
+    static bool load(const char * path, MeshData & mesh)
+    {
+        std::ifstream fin {path, std::ifstream::in | std::ifstream::binary};
+        MeshFileHeader header {};
+
+        if (!fin || !fin.read(reinterpret_cast<char *>(&header), sizeof(MeshFileHeader)) ||
+            std::memcmp(header.magic, "LODM", 4) != 0 || header.version != 1)
+        {
+            return false;
+        }
+
+        mesh.vertices.resize(header.vertexCount);
+        mesh.indices.resize(header.indexCount);
+        mesh.lods.resize(header.lodCount);
+
+        fin.read(reinterpret_cast<char *>(mesh.vertices.data()), mesh.vertices.size() * sizeof(MeshVertex));
+        fin.read(reinterpret_cast<char *>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+        fin.read(reinterpret_cast<char *>(mesh.lods.data()), mesh.lods.size() * sizeof(MeshLod));
+
+        if (!fin || mesh.lods.empty())
+        {
+            return false;
+        }
+
+        // a truncated or corrupt file must not make the draws read outside the buffers
+        for (const MeshLod & lod : mesh.lods)
+        {
+            if (lod.firstIndex > mesh.indices.size() || lod.indexCount > mesh.indices.size() - lod.firstIndex)
+            {
+                return false;
+            }
+        }
+
+        return std::all_of(mesh.indices.begin(), mesh.indices.end(), [&mesh](unsigned int index)
+        {
+            return index < mesh.vertices.size();
+        });
+    }
+
+public:
+    std::vector<MeshVertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshLod> lods;
+};
+
+
+// A MeshData uploaded to the GPU, drawn at the level its projected error allows.
+class LodMesh
+{
+public:
+    explicit LodMesh(const MeshData & mesh) : lods(mesh.lods), radius(mesh.getRadius())
+    {
+        glGenVertexArrays(1, &vertexArray);
+        glBindVertexArray(vertexArray);
+
+        glGenBuffers(1, &vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(MeshVertex), mesh.vertices.data(),
+                     GL_STATIC_DRAW);
+
+        glGenBuffers(1, &indexBuffer);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(),
+                     GL_STATIC_DRAW);
+
+        // position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                              reinterpret_cast<void *>(offsetof(MeshVertex, position)));
+        glEnableVertexAttribArray(0);
+
+        // texture coord attribute
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                              reinterpret_cast<void *>(offsetof(MeshVertex, texCoord)));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+    }
+
+    LodMesh(const LodMesh &) = delete;
+
+    LodMesh & operator=(const LodMesh &) = delete;
+
+    ~LodMesh()
+    {
+        glDeleteVertexArrays(1, &vertexArray);
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteBuffers(1, &indexBuffer);
+    }
+
+    // coarsest level whose error, projected at distance, stays within maxPixelError pixels.
+    // projectionScale is pixels per world unit at distance 1 (Camera::GetProjectionScale), scale the object's scale.
+    int selectLod(float distance, float projectionScale, float scale = 1.0f, float maxPixelError = 1.0f) const
+    {
+        // inside the bounding sphere everything is close
+        distance = std::max(distance - radius * scale, 1e-3f);
+        int level = 0;
+
+        for (int l = 1; l < static_cast<int>(lods.size()); ++l)
+        {
+            if (lods[l].error * scale * projectionScale / distance > maxPixelError)
+            {
+                break;
+            }
+
+            level = l;
+        }
+
+        return level;
+    }
+
+    // the vertex array must be bound (bind())
+    void draw(int level) const
+    {
+        const MeshLod & lod = lods[level];
+        glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT,
+                       reinterpret_cast<void *>(lod.firstIndex * sizeof(unsigned int)));
+    }
+
+    void bind() const
+    {
+        glBindVertexArray(vertexArray);
+    }
+
+    int getLodCount() const
+    {
+        return static_cast<int>(lods.size());
+    }
+
+    std::uint32_t getTriangleCount(int level) const
+    {
+        return lods[level].indexCount / 3;
+    }
+
+    float getRadius() const
+    {
+        return radius;
+    }
+
+private:
+    std::vector<MeshLod> lods;
+    float radius;
+
+    unsigned int vertexArray {0};
+    unsigned int vertexBuffer {0};
+    unsigned int indexBuffer {0};
+};
+
+#endif // LEARNOPENGL_MESH_H
@@ -0,0 +1,445 @@
+#ifndef LEARNOPENGL_MESH_SIMPLIFIER_H
+#define LEARNOPENGL_MESH_SIMPLIFIER_H
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+
+// vertex layout of the sample meshes: position and texture coordinate, like the cube arrays in the samples
+struct MeshVertex
+{
+    glm::vec3 position;
+    glm::vec2 texCoord;
+};
+
+
+// Triangle mesh simplification with quadric error metrics (Garland and Heckbert).
+//
+// Every vertex accumulates the quadric of the planes of its triangles, which measures the squared distance of a
+// point to those planes. Edges are collapsed cheapest first: the collapse a -> b moves a onto b and costs the
+// quadric of both evaluated at b. Collapsing onto an existing vertex keeps texture coordinates exact, and vertices
+// on open borders or texture seams never move, so silhouettes and seams stay intact. Collapses that would flip a
+// triangle are rejected.
+//
+// The reported error is measured, not estimated from the quadrics: the largest distance from a removed vertex to
+// the simplified triangles around the vertex it was collapsed into.
+class MeshSimplifier
+{
+public:
+    // returns the index buffer of the simplified mesh (same vertex buffer) with at most targetIndexCount indices,
+    // or as close as the constraints allow; error receives the object-space deviation bound of the result
+    static std::vector<unsigned int> simplify(const std::vector<MeshVertex> & vertices,
+                                              const std::vector<unsigned int> & indices,
+                                              std::size_t targetIndexCount,
+                                              float & error)
+    {
+        std::size_t vertexCount = vertices.size();
+        std::size_t triangleCount = indices.size() / 3;
+
+        std::vector<unsigned int> triangles(indices.begin(), indices.begin() + 3 * triangleCount);
+        std::vector<bool> removed(triangleCount, false);
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<std::vector<std::uint32_t>> vertexTriangles(vertexCount);
+        std::vector<bool> locked = findLockedVertices(vertices, triangles);
+
+        for (std::size_t t = 0; t != triangleCount; ++t)
+        {
+            const glm::vec3 & p0 = vertices[triangles[3 * t]].position;
+            const glm::vec3 & p1 = vertices[triangles[3 * t + 1]].position;
+            const glm::vec3 & p2 = vertices[triangles[3 * t + 2]].position;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(normal);
+
+            if (length > 0.0f)
+            {
+                normal = normal * (1.0f / length);
+                Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, p0));
+
+                for (int k = 0; k != 3; ++k)
+                {
+                    quadrics[triangles[3 * t + k]] += plane;
+                }
+            }
+
+            for (int k = 0; k != 3; ++k)
+            {
+                vertexTriangles[triangles[3 * t + k]].push_back(static_cast<std::uint32_t>(t));
+            }
+        }
+
+        // candidate collapses, cheapest first; an entry is stale once either vertex changed since it was pushed
+        std::vector<std::uint32_t> versions(vertexCount, 0);
+        std::vector<unsigned int> collapsedInto(vertexCount, kNone);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+
+        auto pushEdges = [&](unsigned int v)
+        {
+            for (std::uint32_t t : vertexTriangles[v])
+            {
+                if (removed[t])
+                {
+                    continue;
+                }
+
+                for (int k = 0; k != 3; ++k)
+                {
+                    unsigned int other = triangles[3 * t + k];
+
+                    if (other == v)
+                    {
+                        continue;
+                    }
+
+                    // both directions, each only if its source may move
+                    for (auto edge : {std::make_pair(v, other), std::make_pair(other, v)})
+                    {
+                        if (!locked[edge.first])
+                        {
+                            Quadric sum = quadrics[edge.first] + quadrics[edge.second];
+                            double cost = std::max(0.0, sum.evaluate(vertices[edge.second].position));
+                            queue.push({cost, edge.first, edge.second, versions[edge.first], versions[edge.second]});
+                        }
+                    }
+                }
+            }
+        };
+
+        for (unsigned int v = 0; v != vertexCount; ++v)
+        {
+            pushEdges(v);
+        }
+
+        std::size_t remaining = triangleCount;
+
+        while (remaining * 3 > targetIndexCount && !queue.empty())
+        {
+            Collapse collapse = queue.top();
+            queue.pop();
+
+            unsigned int a = collapse.from;
+            unsigned int b = collapse.to;
+
+            if (collapse.fromVersion != versions[a] || collapse.toVersion != versions[b] ||
+                vertexTriangles[a].empty() || flips(vertices, triangles, removed, vertexTriangles[a], a, b))
+            {
+                continue;
+            }
+
+            // move a onto b: triangles with both vertices degenerate, the others are handed to b
+            for (std::uint32_t t : vertexTriangles[a])
+            {
+                if (removed[t])
+                {
+                    continue;
+                }
+
+                unsigned int * corner = &triangles[3 * t];
+
+                if (corner[0] == b || corner[1] == b || corner[2] == b)
+                {
+                    removed[t] = true;
+                    --remaining;
+                }
+                else
+                {
+                    std::replace(corner, corner + 3, a, b);
+                    vertexTriangles[b].push_back(t);
+                }
+            }
+
+            vertexTriangles[a].clear();
+            quadrics[b] += quadrics[a];
+            collapsedInto[a] = b;
+            ++versions[a];
+            ++versions[b];
+
+            // the costs around b changed; so did those of b's neighbours that collapse onto b
+            compact(vertexTriangles[b], removed);
+            pushEdges(b);
+        }
+
+        error = measureError(vertices, triangles, removed, vertexTriangles, collapsedInto);
+
+        std::vector<unsigned int> result;
+        result.reserve(remaining * 3);
+
+        for (std::size_t t = 0; t != triangleCount; ++t)
+        {
+            if (!removed[t])
+            {
+                result.insert(result.end(), triangles.begin() + 3 * t, triangles.begin() + 3 * t + 3);
+            }
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr unsigned int kNone = 0xFFFFFFFFu;
+
+    // symmetric 4x4 matrix of a sum of plane quadrics, upper triangle
+    struct Quadric
+    {
+        double a[10];
+
+        static Quadric fromPlane(const glm::vec3 & n, float d)
+        {
+            return {{n.x * n.x, n.x * n.y, n.x * n.z, n.x * d,
+                     n.y * n.y, n.y * n.z, n.y * d,
+                     n.z * n.z, n.z * d,
+                     static_cast<double>(d) * d}};
+        }
+
+        Quadric & operator+=(const Quadric & other)
+        {
+            for (int i = 0; i != 10; ++i)
+            {
+                a[i] += other.a[i];
+            }
+
+            return *this;
+        }
+
+        Quadric operator+(const Quadric & other) const
+        {
+            Quadric sum = *this;
+            return sum += other;
+        }
+
+        // sum of squared distances of p to the planes
+        double evaluate(const glm::vec3 & p) const
+        {
+            double x = p.x;
+            double y = p.y;
+            double z = p.z;
+
+            return a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x +
+                   a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y +
+                   a[7] * z * z + 2 * a[8] * z +
+                   a[9];
+        }
+    };
+
+    struct Collapse
+    {
+        double cost;
+        unsigned int from;
+        unsigned int to;
+        std::uint32_t fromVersion;
+        std::uint32_t toVersion;
+
+        bool operator>(const Collapse & other) const
+        {
+            return cost > other.cost;
+        }
+    };
+
+    // vertices on an open border (edge of one triangle) or a seam (another vertex at the same position)
+    static std::vector<bool> findLockedVertices(const std::vector<MeshVertex> & vertices,
+                                                const std::vector<unsigned int> & triangles)
+    {
+        using Position = std::tuple<float, float, float>;
+
+        std::map<Position, unsigned int> firstAtPosition;
+        std::vector<unsigned int> positionId(vertices.size());
+        std::vector<bool> locked(vertices.size(), false);
+
+        for (unsigned int v = 0; v != vertices.size(); ++v)
+        {
+            const glm::vec3 & p = vertices[v].position;
+            auto inserted = firstAtPosition.emplace(Position(p.x, p.y, p.z), v);
+            positionId[v] = inserted.first->second;
+
+            if (!inserted.second)
+            {
+                locked[v] = true;
+                locked[inserted.first->second] = true;
+            }
+        }
+
+        // an edge used by exactly one triangle (welded by position) is a border
+        std::map<std::pair<unsigned int, unsigned int>, int> edgeUses;
+
+        for (std::size_t i = 0; i != triangles.size(); i += 3)
+        {
+            for (int k = 0; k != 3; ++k)
+            {
+                unsigned int p = positionId[triangles[i + k]];
+                unsigned int q = positionId[triangles[i + (k + 1) % 3]];
+                ++edgeUses[std::minmax(p, q)];
+            }
+        }
+
+        for (std::size_t i = 0; i != triangles.size(); i += 3)
+        {
+            for (int k = 0; k != 3; ++k)
+            {
+                unsigned int u = triangles[i + k];
+                unsigned int v = triangles[i + (k + 1) % 3];
+
+                if (edgeUses[std::minmax(positionId[u], positionId[v])] == 1)
+                {
+                    locked[u] = true;
+                    locked[v] = true;
+                }
+            }
+        }
+
+        return locked;
+    }
+
+    // would moving a onto b turn any surviving triangle of a over (or make it degenerate)?
+    static bool flips(const std::vector<MeshVertex> & vertices, const std::vector<unsigned int> & triangles,
+                      const std::vector<bool> & removed, const std::vector<std::uint32_t> & aTriangles,
+                      unsigned int a, unsigned int b)
+    {
+        for (std::uint32_t t : aTriangles)
+        {
+            const unsigned int * corner = &triangles[3 * t];
+
+            if (removed[t] || corner[0] == b || corner[1] == b || corner[2] == b)
+            {
+                continue;
+            }
+
+            glm::vec3 before[3];
+            glm::vec3 after[3];
+
+            for (int k = 0; k != 3; ++k)
+            {
+                before[k] = vertices[corner[k]].position;
+                after[k] = corner[k] == a ? vertices[b].position : before[k];
+            }
+
+            glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+            glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+            if (glm::dot(n0, n1) <= 0.1f * glm::length(n0) * glm::length(n1))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // largest distance of a removed vertex to the surviving triangles around the vertex it ended up in
+    static float measureError(const std::vector<MeshVertex> & vertices, const std::vector<unsigned int> & triangles,
+                              const std::vector<bool> & removed,
+                              std::vector<std::vector<std::uint32_t>> & vertexTriangles,
+                              const std::vector<unsigned int> & collapsedInto)
+    {
+        float error = 0.0f;
+
+        for (unsigned int v = 0; v != vertices.size(); ++v)
+        {
+            if (collapsedInto[v] == kNone)
+            {
+                continue;
+            }
+
+            unsigned int survivor = collapsedInto[v];
+
+            while (collapsedInto[survivor] != kNone)
+            {
+                survivor = collapsedInto[survivor];
+            }
+
+            compact(vertexTriangles[survivor], removed);
+            float distance = std::numeric_limits<float>::max();
+
+            for (std::uint32_t t : vertexTriangles[survivor])
+            {
+                distance = std::min(distance, pointTriangleDistance(vertices[v].position,
+                                                                    vertices[triangles[3 * t]].position,
+                                                                    vertices[triangles[3 * t + 1]].position,
+                                                                    vertices[triangles[3 * t + 2]].position));
+            }
+
+            if (distance != std::numeric_limits<float>::max())
+            {
+                error = std::max(error, distance);
+            }
+        }
+
+        return error;
+    }
+
+    // distance from p to the triangle abc (Ericson, Real-Time Collision Detection, 5.1.5)
+    static float pointTriangleDistance(const glm::vec3 & p, const glm::vec3 & a, const glm::vec3 & b,
+                                       const glm::vec3 & c)
+    {
+        glm::vec3 ab = b - a;
+        glm::vec3 ac = c - a;
+        glm::vec3 ap = p - a;
+        float d1 = glm::dot(ab, ap);
+        float d2 = glm::dot(ac, ap);
+
+        if (d1 <= 0.0f && d2 <= 0.0f)
+        {
+            return glm::length(ap);
+        }
+
+        glm::vec3 bp = p - b;
+        float d3 = glm::dot(ab, bp);
+        float d4 = glm::dot(ac, bp);
+
+        if (d3 >= 0.0f && d4 <= d3)
+        {
+            return glm::length(bp);
+        }
+
+        float vc = d1 * d4 - d3 * d2;
+
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        {
+            return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+        }
+
+        glm::vec3 cp = p - c;
+        float d5 = glm::dot(ab, cp);
+        float d6 = glm::dot(ac, cp);
+
+        if (d6 >= 0.0f && d5 <= d6)
+        {
+            return glm::length(cp);
+        }
+
+        float vb = d5 * d2 - d1 * d6;
+
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        {
+            return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+        }
+
+        float va = d3 * d6 - d5 * d4;
+
+        if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+        {
+            return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+        }
+
+        float denominator = 1.0f / (va + vb + vc);
+
+        return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+    }
+
+    static void compact(std::vector<std::uint32_t> & list, const std::vector<bool> & removed)
+    {
+        list.erase(std::remove_if(list.begin(), list.end(), [&removed](std::uint32_t t) { return removed[t]; }),
+                   list.end());
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+};
+
+#endif // LEARNOPENGL_MESH_SIMPLIFIER_H
@@ -0,0 +1,199 @@
+#ifndef LEARNOPENGL_RENDER_THREAD_H
+#define LEARNOPENGL_RENDER_THREAD_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+// How the simulation thread is paced against the render thread.
+enum class FramePacing
+{
+    // wait until the previous packet was picked up: at most one frame of latency, simulation runs at display rate
+    Block,
+
+    // never wait: a packet still unconsumed at submit() is replaced by the newer one (dropped), rendering always
+    // shows the latest
+    Latest
+};
+
+
+// A render thread that owns the window's GL context and draws triple-buffered frame packets.
+//
+// The simulation (main) thread fills the packet returned by beginFrame() and hands it over with submit(); the render
+// thread calls the render callback on it and swaps buffers. One slot is read by the render thread, one is written and
+// the third holds the submitted packet until the render thread picks it up, so no packet is ever copied and the
+// pending packet is only ever replaced by a newer one. GLFW event processing stays on the main thread as GLFW requires.
+template <typename Packet>
+class RenderThread
+{
+public:
+    using RenderCallback = std::function<void(const Packet &)>;
+
+    struct Stats
+    {
+        unsigned long long submitted;
+        unsigned long long rendered;
+        unsigned long long dropped;
+        double lastLatency;  // seconds from submit() to the end of glfwSwapBuffers for the last rendered packet
+    };
+
+public:
+    RenderThread(GLFWwindow * window, RenderCallback render, FramePacing pacing = FramePacing::Block,
+                 int swapInterval = 1) :
+            window(window),
+            render(std::move(render)),
+            pacing(pacing),
+            swapInterval(swapInterval)
+    {
+    }
+
+    RenderThread(const RenderThread &) = delete;
+
+    RenderThread & operator=(const RenderThread &) = delete;
+
+    ~RenderThread()
+    {
+        stop();
+    }
+
+    // hands the context over to the render thread; the calling thread must have it current
+    void start()
+    {
+        glfwMakeContextCurrent(nullptr);
+        running = true;
+        worker = std::thread(&RenderThread::renderLoop, this);
+    }
+
+    // joins the render thread and makes the context current on the calling thread again
+    void stop()
+    {
+        if (!worker.joinable())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+
+        condition.notify_all();
+        worker.join();
+        glfwMakeContextCurrent(window);
+    }
+
+    // returns the slot to fill for the next frame, waiting first under FramePacing::Block
+    Packet & beginFrame()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (pacing == FramePacing::Block)
+        {
+            condition.wait(lock, [this] { return pending < 0 || !running; });
+        }
+
+        // the slot neither being drawn nor waiting to be; the pending packet stays available to the render thread
+        writing = 0;
+
+        while (writing == reading || writing == pending)
+        {
+            ++writing;
+        }
+
+        return slots[writing];
+    }
+
+    // publishes the slot returned by beginFrame(), replacing a packet the render thread has not started on yet
+    void submit()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (pending >= 0)
+            {
+                ++stats.dropped;
+            }
+
+            pending = writing;
+            submitTime[writing] = Clock::now();
+            writing = -1;
+            ++stats.submitted;
+        }
+
+        condition.notify_all();
+    }
+
+    Stats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void renderLoop()
+    {
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(swapInterval);
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this] { return pending >= 0 || !running; });
+
+                if (!running)
+                {
+                    break;
+                }
+
+                reading = pending;
+                pending = -1;
+            }
+
+            // let a blocked producer start on another slot while this one is drawn
+            condition.notify_all();
+
+            render(slots[reading]);
+            glfwSwapBuffers(window);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stats.lastLatency = std::chrono::duration<double>(Clock::now() - submitTime[reading]).count();
+                ++stats.rendered;
+                reading = -1;
+            }
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
+private:
+    GLFWwindow * window;
+    RenderCallback render;
+    FramePacing pacing;
+    int swapInterval;
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    bool running {false};
+
+    // triple buffer: the render thread reads one slot, the producer writes another, the third is pending
+    Packet slots[3];
+    Clock::time_point submitTime[3];
+    int reading {-1};
+    int writing {-1};
+    int pending {-1};
+
+    Stats stats {0, 0, 0, 0.0};
+};
+
+#endif // LEARNOPENGL_RENDER_THREAD_H
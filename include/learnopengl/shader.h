@@ -21,13 +21,7 @@ public:
         std::string vertShaderCode;
         std::string fragShaderCode;
 
-        if (std::ifstream fin {vertShaderPath, std::ifstream::in})
-        {
-            std::ostringstream sout;
-            sout << fin.rdbuf();
-            vertShaderCode = sout.str();
-        }
-        else
+        if (!readFile(vertShaderPath, vertShaderCode))
         {
             std::cout << std::unitbuf
                       << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
@@ -37,51 +31,126 @@ public:
             std::abort();
         }
 
-        if (std::ifstream fin {fragShaderPath, std::ifstream::in})
+        if (!readFile(fragShaderPath, fragShaderCode))
         {
-            std::ostringstream sout;
-            sout << fin.rdbuf();
-            fragShaderCode = sout.str();
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Fragment shader file not successfully read!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
         }
-        else
+
+        // 2. compile shaders
+
+        std::string errorLog;
+        shaderProgram = compileProgram(vertShaderCode, fragShaderCode, errorLog);
+
+        if (!shaderProgram)
         {
             std::cout << std::unitbuf
                       << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
-                      << "\n[ERROR] " << "Fragment shader file not successfully read!"
+                      << "\n[ERROR] " << errorLog
                       << std::nounitbuf << std::endl;
 
             std::abort();
         }
+    }
+
+    // wraps an already linked program
+    explicit Shader(unsigned int program) : shaderProgram(program)
+    {
+    }
+
+    // reads a whole text file, returns false if it could not be opened
+    static bool readFile(const char * path, std::string & code)
+    {
+        if (std::ifstream fin {path, std::ifstream::in})
+        {
+            std::ostringstream sout;
+            sout << fin.rdbuf();
+            code = sout.str();
+            return true;
+        }
+
+        return false;
+    }
 
+    // compiles and links a program, returns 0 and fills errorLog on failure instead of aborting
+    static unsigned int compileProgram(const std::string & vertShaderCode,
+                                       const std::string & fragShaderCode,
+                                       std::string & errorLog)
+    {
+        unsigned int vertexShader;
+        unsigned int fragmentShader;
+        unsigned int program = submitProgram(vertShaderCode, fragShaderCode, vertexShader, fragmentShader);
+        return finishProgram(program, vertexShader, fragmentShader, errorLog);
+    }
+
+    // issues compile and link without querying any status, so the driver may work on it asynchronously
+    static unsigned int submitProgram(const std::string & vertShaderCode,
+                                      const std::string & fragShaderCode,
+                                      unsigned int & vertexShader,
+                                      unsigned int & fragmentShader)
+    {
         const char * vertShaderPtr = vertShaderCode.data();
         const char * fragShaderPtr = fragShaderCode.data();
 
-        // 2. compile shaders
-
         // vertexShader shader
-        unsigned int vertexShader;
         vertexShader = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertexShader, 1, &vertShaderPtr, nullptr);
         glCompileShader(vertexShader);
-        checkCompileErrors(vertexShader, "VERTEX");
 
         // fragmentShader shader
-        unsigned int fragmentShader;
         fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragmentShader, 1, &fragShaderPtr, nullptr);
         glCompileShader(fragmentShader);
-        checkCompileErrors(fragmentShader, "FRAGMENT");
 
         // shader program
-        shaderProgram = glCreateProgram();
-        glAttachShader(shaderProgram, vertexShader);
-        glAttachShader(shaderProgram, fragmentShader);
-        glLinkProgram(shaderProgram);
-        checkCompileErrors(shaderProgram, "PROGRAM");
+        unsigned int program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+
+        return program;
+    }
+
+    // checks (and thereby waits for) a submitted program, returns 0 and fills errorLog on failure
+    static unsigned int finishProgram(unsigned int program,
+                                      unsigned int vertexShader,
+                                      unsigned int fragmentShader,
+                                      std::string & errorLog)
+    {
+        bool success = checkCompileErrors(vertexShader, "VERTEX", errorLog) &&
+                       checkCompileErrors(fragmentShader, "FRAGMENT", errorLog) &&
+                       checkCompileErrors(program, "PROGRAM", errorLog);
 
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
+
+        if (!success)
+        {
+            glDeleteProgram(program);
+            return 0;
+        }
+
+        return program;
+    }
+
+    // replaces the program (e.g. after a hot reload), keeping it active if the old one was
+    void swapProgram(unsigned int program)
+    {
+        int current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+
+        if (static_cast<unsigned int>(current) == shaderProgram)
+        {
+            glUseProgram(program);
+        }
+
+        glDeleteProgram(shaderProgram);
+        shaderProgram = program;
     }
 
     void use()
@@ -89,64 +158,65 @@ public:
         glUseProgram(shaderProgram);
     }
 
-    void setBool(const std::string & name, bool value) const
+    // names are taken as C strings, so calls with literals do not build a std::string on every set
+    void setBool(const char * name, bool value) const
     {
-        glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), (int) value);
+        glUniform1i(glGetUniformLocation(shaderProgram, name), (int) value);
     }
 
-    void setInt(const std::string & name, int value) const
+    void setInt(const char * name, int value) const
     {
-        glUniform1i(glGetUniformLocation(shaderProgram, name.c_str()), value);
+        glUniform1i(glGetUniformLocation(shaderProgram, name), value);
     }
 
-    void setFloat(const std::string & name, float value) const
+    void setFloat(const char * name, float value) const
     {
-        glUniform1f(glGetUniformLocation(shaderProgram, name.c_str()), value);
+        glUniform1f(glGetUniformLocation(shaderProgram, name), value);
     }
 
-    void setVec2(const std::string &name, const glm::vec2 &value) const
+    void setVec2(const char * name, const glm::vec2 &value) const
     {
-        glUniform2fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+        glUniform2fv(glGetUniformLocation(shaderProgram, name), 1, &value[0]);
     }
 
-    void setVec2(const std::string &name, float x, float y) const
+    void setVec2(const char * name, float x, float y) const
     {
-        glUniform2f(glGetUniformLocation(shaderProgram, name.c_str()), x, y);
+        glUniform2f(glGetUniformLocation(shaderProgram, name), x, y);
     }
 
-    void setVec3(const std::string &name, const glm::vec3 &value) const
+    void setVec3(const char * name, const glm::vec3 &value) const
     {
-        glUniform3fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+        glUniform3fv(glGetUniformLocation(shaderProgram, name), 1, &value[0]);
     }
 
-    void setVec3(const std::string &name, float x, float y, float z) const
+    void setVec3(const char * name, float x, float y, float z) const
     {
-        glUniform3f(glGetUniformLocation(shaderProgram, name.c_str()), x, y, z);
+        glUniform3f(glGetUniformLocation(shaderProgram, name), x, y, z);
     }
 
-    void setVec4(const std::string &name, const glm::vec4 &value) const
+    void setVec4(const char * name, const glm::vec4 &value) const
     {
-        glUniform4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, &value[0]);
+        glUniform4fv(glGetUniformLocation(shaderProgram, name), 1, &value[0]);
     }
 
-    void setVec4(const std::string &name, float x, float y, float z, float w) const
+    void setVec4(const char * name, float x, float y, float z, float w) const
     {
-        glUniform4f(glGetUniformLocation(shaderProgram, name.c_str()), x, y, z, w);
+        glUniform4f(glGetUniformLocation(shaderProgram, name), x, y, z, w);
     }
 
-    void setMat2(const std::string &name, const glm::mat2 &mat) const
+    void setMat2(const char * name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(glGetUniformLocation(shaderProgram, name), 1, GL_FALSE, &mat[0][0]);
     }
 
-    void setMat3(const std::string &name, const glm::mat3 &mat) const
+    void setMat3(const char * name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(glGetUniformLocation(shaderProgram, name), 1, GL_FALSE, &mat[0][0]);
     }
 
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    void setMat4(const char * name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, name), 1, GL_FALSE, &mat[0][0]);
     }
 
     unsigned int getShaderProgramHandle() const
@@ -156,7 +226,7 @@ public:
 
 private:
     // utility function for checking shader compilation/linking errors.
-    static void checkCompileErrors(unsigned int shader, const std::string & type)
+    static bool checkCompileErrors(unsigned int shader, const std::string & type, std::string & errorLog)
     {
         int success;
         char infoLog[1024];
@@ -168,14 +238,8 @@ private:
             if (!success)
             {
                 glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-
-                std::cout << std::unitbuf
-                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
-                          << "\n[ERROR] " << type << " shader compilation failed"
-                          << "\n[ERROR] " << infoLog
-                          << std::nounitbuf << std::endl;
-
-                std::abort();
+                errorLog = type + " shader compilation failed\n" + infoLog;
+                return false;
             }
         }
         else
@@ -185,16 +249,12 @@ private:
             if (!success)
             {
                 glGetProgramInfoLog(shader, 1024, nullptr, infoLog);
-
-                std::cout << std::unitbuf
-                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
-                          << "\n[ERROR] " << R"(Shader program linking failed)"
-                          << "\n[ERROR] " << infoLog
-                          << std::nounitbuf << std::endl;
-
-                std::abort();
+                errorLog = std::string("Shader program linking failed\n") + infoLog;
+                return false;
             }
         }
+
+        return true;
     }
 
 private:
@@ -0,0 +1,142 @@
+#ifndef LEARNOPENGL_SHADER_BATCH_H
+#define LEARNOPENGL_SHADER_BATCH_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "learnopengl/shader.h"
+
+
+// Compiles many programs without serializing on each one.
+//
+// add() only submits compile and link commands; no status is queried until the program is first needed in get().
+// With GL_KHR_parallel_shader_compile (or the ARB variant) the driver compiles on its own worker threads and
+// isReady() polls GL_COMPLETION_STATUS_KHR, so the caller can keep rendering a loading screen meanwhile.
+// Without the extension the work still overlaps as far as the driver defers it, and isReady() reports true.
+class ShaderBatch
+{
+public:
+    ShaderBatch()
+    {
+        if (GLAD_GL_KHR_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);  // let the implementation choose
+            parallel = true;
+        }
+        else if (GLAD_GL_ARB_parallel_shader_compile)
+        {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+            parallel = true;
+        }
+    }
+
+    // reads both sources and submits the program, returns its index in the batch
+    std::size_t add(const char * vertShaderPath, const char * fragShaderPath)
+    {
+        std::string vertShaderCode;
+        std::string fragShaderCode;
+
+        if (!Shader::readFile(vertShaderPath, vertShaderCode) || !Shader::readFile(fragShaderPath, fragShaderCode))
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Shader file not successfully read: "
+                      << vertShaderPath << ", " << fragShaderPath
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        return addSource(vertShaderCode, fragShaderCode);
+    }
+
+    // submits a program from (e.g. preprocessed) source code, returns its index in the batch
+    std::size_t addSource(const std::string & vertShaderCode, const std::string & fragShaderCode)
+    {
+        Pending pending {};
+        pending.program = Shader::submitProgram(vertShaderCode, fragShaderCode,
+                                                pending.vertexShader, pending.fragmentShader);
+        programs.push_back(pending);
+
+        return programs.size() - 1;
+    }
+
+    // true once the program at index has finished compiling and linking (never blocks)
+    bool isReady(std::size_t index) const
+    {
+        const Pending & pending = programs.at(index);
+
+        if (pending.finished || !parallel)
+        {
+            return true;
+        }
+
+        int complete = GL_FALSE;
+        glGetProgramiv(pending.program, GL_COMPLETION_STATUS_KHR, &complete);
+
+        return complete == GL_TRUE;
+    }
+
+    // true once every program in the batch is ready
+    bool isReady() const
+    {
+        for (std::size_t i = 0; i != programs.size(); ++i)
+        {
+            if (!isReady(i))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // first use: waits for the program if necessary, aborts with the info log on errors like Shader does
+    Shader get(std::size_t index)
+    {
+        Pending & pending = programs.at(index);
+
+        if (!pending.finished)
+        {
+            std::string errorLog;
+            pending.program = Shader::finishProgram(pending.program, pending.vertexShader, pending.fragmentShader,
+                                                    errorLog);
+            pending.finished = true;
+
+            if (!pending.program)
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << errorLog
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+        }
+
+        return Shader(pending.program);
+    }
+
+    bool isParallel() const
+    {
+        return parallel;
+    }
+
+private:
+    struct Pending
+    {
+        unsigned int program;
+        unsigned int vertexShader;
+        unsigned int fragmentShader;
+        bool finished;
+    };
+
+    std::vector<Pending> programs;
+    bool parallel {false};
+};
+
+#endif // LEARNOPENGL_SHADER_BATCH_H
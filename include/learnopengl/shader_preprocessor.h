@@ -0,0 +1,391 @@
+#ifndef LEARNOPENGL_SHADER_PREPROCESSOR_H
+#define LEARNOPENGL_SHADER_PREPROCESSOR_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "learnopengl/shader.h"
+
+
+// Expands GLSL sources before compilation:
+//   - #include "file" (relative to the including file, then to each include directory), each file at most once
+//   - a set of feature defines ("NAME" or "NAME=VALUE") injected right after #version
+//   - #line directives so compiler messages point at the original file (source string number = index into files)
+class ShaderPreprocessor
+{
+public:
+    struct Result
+    {
+        std::string code;
+        std::vector<std::string> files;  // every file that went into code, usable as dependency list
+    };
+
+public:
+    explicit ShaderPreprocessor(std::vector<std::string> includeDirectories = {}) :
+            includeDirectories(std::move(includeDirectories))
+    {
+    }
+
+    Result process(const std::string & path, std::vector<std::string> defines = {}) const
+    {
+        Result result;
+        std::string errorLog;
+
+        if (!tryProcess(path, std::move(defines), result, errorLog))
+        {
+            fail(errorLog);
+        }
+
+        return result;
+    }
+
+    // process() that reports a missing file or malformed #include in errorLog instead of aborting, e.g. for hot
+    // reload, where the sources may be mid-edit; result.files lists the files read up to the error
+    bool tryProcess(const std::string & path, std::vector<std::string> defines, Result & result,
+                    std::string & errorLog) const
+    {
+        // the order of defines must not produce distinct sources for the same permutation
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+
+        result = Result();
+        std::unordered_set<std::string> included;
+        std::vector<std::string> stack;
+
+        return expand(path, defines, result, included, stack, errorLog);
+    }
+
+private:
+    static std::string directoryOf(const std::string & path)
+    {
+        std::size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    static std::string trimLeft(const std::string & line)
+    {
+        std::size_t first = line.find_first_not_of(" \t");
+        return first == std::string::npos ? std::string() : line.substr(first);
+    }
+
+    static std::string defineLine(const std::string & define)
+    {
+        std::size_t equal = define.find('=');
+
+        if (equal == std::string::npos)
+        {
+            return "#define " + define + '\n';
+        }
+
+        return "#define " + define.substr(0, equal) + ' ' + define.substr(equal + 1) + '\n';
+    }
+
+    // GLSL 3.30 semantics: after "#line n s" the next line is numbered n + 1
+    static std::string lineDirective(int nextLine, std::size_t file)
+    {
+        return "#line " + std::to_string(nextLine - 1) + ' ' + std::to_string(file) + '\n';
+    }
+
+    [[noreturn]] static void fail(const std::string & message)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << message
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // the path of an included file; empty if it is found neither next to the including file nor in an include directory
+    std::string resolve(const std::string & includingFile, const std::string & name) const
+    {
+        std::string candidate = directoryOf(includingFile) + name;
+        std::string code;
+
+        if (Shader::readFile(candidate.c_str(), code))
+        {
+            return candidate;
+        }
+
+        for (const std::string & directory : includeDirectories)
+        {
+            candidate = directory + '/' + name;
+
+            if (Shader::readFile(candidate.c_str(), code))
+            {
+                return candidate;
+            }
+        }
+
+        return std::string();
+    }
+
+    bool expand(const std::string & path,
+                const std::vector<std::string> & defines,
+                Result & result,
+                std::unordered_set<std::string> & included,
+                std::vector<std::string> & stack,
+                std::string & errorLog) const
+    {
+        if (std::find(stack.begin(), stack.end(), path) != stack.end())
+        {
+            errorLog = "Recursive #include of " + path;
+            return false;
+        }
+
+        if (!included.insert(path).second)
+        {
+            return true;
+        }
+
+        std::string source;
+
+        if (!Shader::readFile(path.c_str(), source))
+        {
+            errorLog = "Shader file not successfully read: " + path;
+            return false;
+        }
+
+        std::size_t file = result.files.size();
+        result.files.push_back(path);
+        stack.push_back(path);
+
+        if (file != 0)
+        {
+            result.code += lineDirective(1, file);
+        }
+
+        std::istringstream sin(source);
+        std::string line;
+        int lineNumber = 0;
+
+        while (std::getline(sin, line))
+        {
+            ++lineNumber;
+            std::string directive = trimLeft(line);
+
+            if (directive.compare(0, 8, "#include") == 0)
+            {
+                std::size_t open = directive.find_first_of("\"<", 8);
+                std::size_t close = open == std::string::npos ? open : directive.find_first_of("\">", open + 1);
+
+                if (close == std::string::npos)
+                {
+                    errorLog = "Malformed #include at " + path + ':' + std::to_string(lineNumber);
+                    return false;
+                }
+
+                std::string name = directive.substr(open + 1, close - open - 1);
+                std::string includedPath = resolve(path, name);
+
+                if (includedPath.empty())
+                {
+                    errorLog = "Cannot resolve #include \"" + name + "\" in " + path;
+                    return false;
+                }
+
+                if (!expand(includedPath, defines, result, included, stack, errorLog))
+                {
+                    return false;
+                }
+
+                result.code += lineDirective(lineNumber + 1, file);
+            }
+            else if (directive.compare(0, 12, "#pragma once") == 0)
+            {
+                result.code += '\n';
+            }
+            else if (file == 0 && directive.compare(0, 8, "#version") == 0)
+            {
+                result.code += line + '\n';
+
+                for (const std::string & define : defines)
+                {
+                    result.code += defineLine(define);
+                }
+
+                result.code += lineDirective(lineNumber + 1, file);
+            }
+            else
+            {
+                result.code += line + '\n';
+            }
+        }
+
+        stack.pop_back();
+
+        return true;
+    }
+
+private:
+    std::vector<std::string> includeDirectories;
+};
+
+
+// Compiles each distinct expanded (vertex, fragment) source pair once.
+//
+// A request is first looked up by its canonical file paths and sorted defines, so asking for the same permutation
+// again returns its program without reading or preprocessing any file. A new request is preprocessed and keyed by a
+// 64-bit FNV-1a hash of the expanded sources, so define sets that expand to identical code (or identical files
+// reached through different paths) share a single program object. The cache owns its programs: they are deleted by
+// clear(), not by the caller, and the cache does not notice edits to the files (see ShaderWatcher for hot reload).
+class ShaderCache
+{
+public:
+    explicit ShaderCache(ShaderPreprocessor preprocessor = ShaderPreprocessor()) :
+            preprocessor(std::move(preprocessor))
+    {
+    }
+
+    ShaderCache(const ShaderCache &) = delete;
+
+    ShaderCache & operator=(const ShaderCache &) = delete;
+
+    // deletes every program handed out by this cache
+    void clear()
+    {
+        for (auto & entry : programs)
+        {
+            glDeleteProgram(entry.second.program);
+        }
+
+        for (unsigned int program : uncached)
+        {
+            glDeleteProgram(program);
+        }
+
+        programs.clear();
+        requests.clear();
+        uncached.clear();
+    }
+
+    Shader get(const std::string & vertShaderPath,
+               const std::string & fragShaderPath,
+               std::vector<std::string> defines = {})
+    {
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+
+        std::string request = canonical(vertShaderPath) + '\n' + canonical(fragShaderPath);
+
+        for (const std::string & define : defines)
+        {
+            request += '\n' + define;
+        }
+
+        auto known = requests.find(request);
+
+        if (known != requests.end())
+        {
+            ++hits;
+            return Shader(known->second);
+        }
+
+        ++preprocessed;
+        std::string vertShaderCode = preprocessor.process(vertShaderPath, defines).code;
+        std::string fragShaderCode = preprocessor.process(fragShaderPath, defines).code;
+
+        std::uint64_t key = hash(vertShaderCode, hash(fragShaderCode));
+        auto it = programs.find(key);
+
+        if (it != programs.end() &&
+            it->second.vertShaderCode == vertShaderCode && it->second.fragShaderCode == fragShaderCode)
+        {
+            ++hits;
+            requests.emplace(std::move(request), it->second.program);
+            return Shader(it->second.program);
+        }
+
+        std::string errorLog;
+        unsigned int program = Shader::compileProgram(vertShaderCode, fragShaderCode, errorLog);
+
+        if (!program)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << vertShaderPath << " + " << fragShaderPath
+                      << "\n[ERROR] " << errorLog
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        requests.emplace(std::move(request), program);
+
+        if (it != programs.end())
+        {
+            // a genuine 64-bit collision: keep the older program keyed by its source, this one only by request
+            uncached.push_back(program);
+            return Shader(program);
+        }
+
+        programs.emplace(key, Entry {program, std::move(vertShaderCode), std::move(fragShaderCode)});
+
+        return Shader(program);
+    }
+
+    std::size_t getProgramCount() const
+    {
+        return programs.size();
+    }
+
+    // requests answered with an existing program, with or without preprocessing
+    std::size_t getHitCount() const
+    {
+        return hits;
+    }
+
+    // requests that had to be preprocessed: the first of each permutation
+    std::size_t getPreprocessCount() const
+    {
+        return preprocessed;
+    }
+
+    static std::uint64_t hash(const std::string & text, std::uint64_t seed = 14695981039346656037ULL)
+    {
+        std::uint64_t h = seed;
+
+        for (unsigned char c : text)
+        {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+
+        return h;
+    }
+
+private:
+    struct Entry
+    {
+        unsigned int program;
+        std::string vertShaderCode;
+        std::string fragShaderCode;
+    };
+
+    // the same file for every spelling of its path, whether or not it exists
+    static std::string canonical(const std::string & path)
+    {
+        std::error_code ec;
+        std::filesystem::path result = std::filesystem::weakly_canonical(path, ec);
+        return ec ? path : result.string();
+    }
+
+private:
+    ShaderPreprocessor preprocessor;
+    std::unordered_map<std::uint64_t, Entry> programs;
+    std::unordered_map<std::string, unsigned int> requests;     // canonical paths and defines to program
+    std::vector<unsigned int> uncached;                         // programs whose source hash collided
+    std::size_t hits {0};
+    std::size_t preprocessed {0};
+};
+
+#endif // LEARNOPENGL_SHADER_PREPROCESSOR_H
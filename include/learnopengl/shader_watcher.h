@@ -0,0 +1,506 @@
+#ifndef LEARNOPENGL_SHADER_WATCHER_H
+#define LEARNOPENGL_SHADER_WATCHER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
+
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_preprocessor.h"
+
+
+// Hot reload for Shader objects.
+//
+// A background thread watches the shader source files and everything they #include (inotify on Linux, modification
+// times elsewhere) and recompiles changed programs, expanded by ShaderPreprocessor with their defines, on a hidden
+// context that shares objects with the main window. Finished programs are fenced and handed back to the render
+// thread, which swaps them in at a frame boundary in poll().
+// A program that fails to compile or link only prints its log; the last good program stays in use.
+class ShaderWatcher
+{
+public:
+    using ReloadCallback = std::function<void(Shader &)>;
+
+public:
+    // must be called on the main thread, after the window's context has been created and GLAD loaded
+    explicit ShaderWatcher(GLFWwindow * mainWindow, ShaderPreprocessor preprocessor = ShaderPreprocessor()) :
+            preprocessor(std::move(preprocessor))
+    {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        sharedWindow = glfwCreateWindow(1, 1, "ShaderWatcher", nullptr, mainWindow);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+        if (!sharedWindow)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Failed to create shared GLFW context!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+#ifdef __linux__
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (inotifyFd < 0)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "inotify_init1 failed!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+#endif
+    }
+
+    ShaderWatcher(const ShaderWatcher &) = delete;
+
+    ShaderWatcher & operator=(const ShaderWatcher &) = delete;
+
+    ~ShaderWatcher()
+    {
+        stopping = true;
+
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+
+        // programs compiled but never swapped in
+        for (Ready & ready : readyPrograms)
+        {
+            glDeleteSync(ready.fence);
+            glDeleteProgram(ready.program);
+        }
+
+#ifdef __linux__
+        close(inotifyFd);
+#endif
+
+        glfwDestroyWindow(sharedWindow);
+    }
+
+    // starts watching the sources of shader, which was built from them with defines; onReload runs on the render
+    // thread right after each swap
+    void watch(Shader & shader, const std::string & vertShaderPath, const std::string & fragShaderPath,
+               ReloadCallback onReload = nullptr, std::vector<std::string> defines = {})
+    {
+        std::vector<std::string> files = findFiles(vertShaderPath, fragShaderPath, defines);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        entries.push_back({&shader, vertShaderPath, fragShaderPath, std::move(defines), files,
+                           std::move(onReload), false});
+
+        for (const std::string & path : files)
+        {
+            watchFile(path);
+        }
+
+        if (!worker.joinable())
+        {
+            worker = std::thread(&ShaderWatcher::watchLoop, this);
+        }
+    }
+
+    // swaps in every recompiled program whose GPU work has finished; call once per frame, before drawing
+    void poll()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (auto it = readyPrograms.begin(); it != readyPrograms.end(); )
+        {
+            GLenum status = glClientWaitSync(it->fence, 0, 0);
+
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            {
+                ++it;
+                continue;
+            }
+
+            glDeleteSync(it->fence);
+
+            Entry & entry = entries[it->entry];
+            copyUniforms(entry.shader->getShaderProgramHandle(), it->program);
+            entry.shader->swapProgram(it->program);
+
+            std::cout << "[INFO] reloaded " << entry.vertShaderPath << " + " << entry.fragShaderPath << std::endl;
+
+            if (entry.onReload)
+            {
+                entry.onReload(*entry.shader);
+            }
+
+            it = readyPrograms.erase(it);
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Shader * shader;
+        std::string vertShaderPath;
+        std::string fragShaderPath;
+        std::vector<std::string> defines;
+        std::vector<std::string> files;     // both sources and everything they include
+        ReloadCallback onReload;
+        bool dirty;
+    };
+
+    struct Ready
+    {
+        std::size_t entry;
+        unsigned int program;
+        GLsync fence;
+    };
+
+    static std::pair<std::string, std::string> splitPath(const std::string & path)
+    {
+        std::size_t slash = path.find_last_of('/');
+
+        if (slash == std::string::npos)
+        {
+            return {".", path};
+        }
+
+        return {path.substr(0, slash), path.substr(slash + 1)};
+    }
+
+    // the files of both stages; where a stage does not preprocess, at least its own source, so fixing it reloads
+    std::vector<std::string> findFiles(const std::string & vertShaderPath, const std::string & fragShaderPath,
+                                       const std::vector<std::string> & defines) const
+    {
+        std::vector<std::string> files;
+
+        for (const std::string & path : {vertShaderPath, fragShaderPath})
+        {
+            ShaderPreprocessor::Result result;
+            std::string errorLog;
+            preprocessor.tryProcess(path, defines, result, errorLog);
+
+            if (result.files.empty())
+            {
+                result.files.push_back(path);
+            }
+
+            for (const std::string & file : result.files)
+            {
+                if (std::find(files.begin(), files.end(), file) == files.end())
+                {
+                    files.push_back(file);
+                }
+            }
+        }
+
+        return files;
+    }
+
+    // with mutex held
+    void watchFile(const std::string & path)
+    {
+#ifdef __linux__
+        // watch the directory: editors commonly save by writing a temporary file and renaming it over the original
+        std::string directory = splitPath(path).first;
+
+        if (watchedDirectories.count(directory) == 0)
+        {
+            int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+            if (wd < 0)
+            {
+                std::cout << "[WARNING] inotify_add_watch failed for " << directory << std::endl;
+                return;
+            }
+
+            watchedDirectories.emplace(directory, wd);
+            directoryOfWatch.emplace(wd, directory);
+        }
+#else
+        if (modificationTimes.count(path) == 0)
+        {
+            std::error_code ec;
+            modificationTimes.emplace(path, std::filesystem::last_write_time(path, ec));
+        }
+#endif
+    }
+
+    void markDirty(const std::string & path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for (Entry & entry : entries)
+        {
+            if (std::find(entry.files.begin(), entry.files.end(), path) != entry.files.end())
+            {
+                entry.dirty = true;
+            }
+        }
+    }
+
+    // collects file change notifications into Entry::dirty
+    void collectChanges()
+    {
+#ifdef __linux__
+        pollfd pfd {inotifyFd, POLLIN, 0};
+
+        if (::poll(&pfd, 1, 100) <= 0)
+        {
+            return;
+        }
+
+        alignas(inotify_event) char buffer[4096];
+        ssize_t length;
+
+        while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char * p = buffer; p < buffer + length; )
+            {
+                auto * event = reinterpret_cast<inotify_event *>(p);
+
+                if (event->len != 0)
+                {
+                    std::string directory;
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        directory = directoryOfWatch[event->wd];
+                    }
+
+                    markDirty(directory == "." ? std::string(event->name) : directory + '/' + event->name);
+                }
+
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // watch() and recompile() add files concurrently: check a copy, then record the changes under the lock
+        std::unordered_map<std::string, std::filesystem::file_time_type> times;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            times = modificationTimes;
+        }
+
+        std::vector<std::string> changed;
+
+        for (const auto & file : times)
+        {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(file.first, ec);
+
+            if (!ec && time != file.second)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                modificationTimes[file.first] = time;
+                changed.push_back(file.first);
+            }
+        }
+
+        for (const std::string & path : changed)
+        {
+            markDirty(path);
+        }
+#endif
+    }
+
+    void watchLoop()
+    {
+        glfwMakeContextCurrent(sharedWindow);
+
+        while (!stopping)
+        {
+            collectChanges();
+
+            // let bursts of events from a single save settle before reading the files
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            std::vector<std::size_t> dirty;
+            std::vector<Entry> snapshot;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                for (std::size_t i = 0; i != entries.size(); ++i)
+                {
+                    if (entries[i].dirty)
+                    {
+                        entries[i].dirty = false;
+                        dirty.push_back(i);
+                        snapshot.push_back(entries[i]);
+                    }
+                }
+            }
+
+            for (std::size_t i = 0; i != dirty.size(); ++i)
+            {
+                recompile(dirty[i], snapshot[i]);
+            }
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    void recompile(std::size_t index, const Entry & entry)
+    {
+        // an edit may have added or removed includes
+        std::vector<std::string> files = findFiles(entry.vertShaderPath, entry.fragShaderPath, entry.defines);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries[index].files = files;
+
+            for (const std::string & path : files)
+            {
+                watchFile(path);
+            }
+        }
+
+        ShaderPreprocessor::Result vertShader;
+        ShaderPreprocessor::Result fragShader;
+        std::string errorLog;
+
+        if (!preprocessor.tryProcess(entry.vertShaderPath, entry.defines, vertShader, errorLog) ||
+            !preprocessor.tryProcess(entry.fragShaderPath, entry.defines, fragShader, errorLog))
+        {
+            std::cout << "[WARNING] shader reload skipped, keeping the last good program\n"
+                      << "[WARNING] " << errorLog << std::endl;
+            return;
+        }
+
+        unsigned int program = Shader::compileProgram(vertShader.code, fragShader.code, errorLog);
+
+        if (!program)
+        {
+            std::cout << "[WARNING] shader reload failed, keeping the last good program\n"
+                      << "[WARNING] " << errorLog << std::endl;
+            return;
+        }
+
+        // the render thread may only use the program once this context's commands have completed
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        readyPrograms.push_back({index, program, fence});
+    }
+
+    // carries the current values of the plain (non-array) uniforms over to the recompiled program
+    static void copyUniforms(unsigned int from, unsigned int to)
+    {
+        int count = 0;
+        glGetProgramiv(from, GL_ACTIVE_UNIFORMS, &count);
+
+        int current = 0;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+        glUseProgram(to);
+
+        for (int i = 0; i != count; ++i)
+        {
+            char name[256];
+            int size = 0;
+            GLenum type = GL_NONE;
+            glGetActiveUniform(from, i, sizeof(name), nullptr, &size, &type, name);
+
+            int src = glGetUniformLocation(from, name);
+            int dst = glGetUniformLocation(to, name);
+
+            if (size != 1 || src < 0 || dst < 0)
+            {
+                continue;
+            }
+
+            float f[16];
+            int n[4];
+
+            switch (type)
+            {
+            case GL_FLOAT:
+                glGetUniformfv(from, src, f);
+                glUniform1fv(dst, 1, f);
+                break;
+            case GL_FLOAT_VEC2:
+                glGetUniformfv(from, src, f);
+                glUniform2fv(dst, 1, f);
+                break;
+            case GL_FLOAT_VEC3:
+                glGetUniformfv(from, src, f);
+                glUniform3fv(dst, 1, f);
+                break;
+            case GL_FLOAT_VEC4:
+                glGetUniformfv(from, src, f);
+                glUniform4fv(dst, 1, f);
+                break;
+            case GL_FLOAT_MAT2:
+                glGetUniformfv(from, src, f);
+                glUniformMatrix2fv(dst, 1, GL_FALSE, f);
+                break;
+            case GL_FLOAT_MAT3:
+                glGetUniformfv(from, src, f);
+                glUniformMatrix3fv(dst, 1, GL_FALSE, f);
+                break;
+            case GL_FLOAT_MAT4:
+                glGetUniformfv(from, src, f);
+                glUniformMatrix4fv(dst, 1, GL_FALSE, f);
+                break;
+            case GL_INT:
+            case GL_BOOL:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_2D:
+                glGetUniformiv(from, src, n);
+                glUniform1iv(dst, 1, n);
+                break;
+            default:
+                break;
+            }
+        }
+
+        glUseProgram(static_cast<unsigned int>(current));
+    }
+
+private:
+    GLFWwindow * sharedWindow {nullptr};
+
+    std::thread worker;
+    std::atomic<bool> stopping {false};
+
+    ShaderPreprocessor preprocessor;
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<Ready> readyPrograms;
+
+#ifdef __linux__
+    int inotifyFd {-1};
+    std::unordered_map<std::string, int> watchedDirectories;
+    std::unordered_map<int, std::string> directoryOfWatch;
+#else
+    std::unordered_map<std::string, std::filesystem::file_time_type> modificationTimes;
+#endif
+};
+
+#endif // LEARNOPENGL_SHADER_WATCHER_H
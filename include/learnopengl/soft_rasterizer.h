@@ -0,0 +1,679 @@
+#ifndef LEARNOPENGL_SOFT_RASTERIZER_H
+#define LEARNOPENGL_SOFT_RASTERIZER_H
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "learnopengl/job_system.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEARNOPENGL_SOFT_RASTERIZER_SSE
+#endif
+
+
+// An RGBA texture with its mipmap chain, sampled like GL_REPEAT with GL_LINEAR_MIPMAP_LINEAR.
+class SoftTexture
+{
+public:
+    SoftTexture() = default;
+
+    // rows as glTexImage2D reads them: bottom row first, channels 3 (RGB) or 4 (RGBA) bytes per texel;
+    // rowBytes of 0 means tightly packed
+    SoftTexture(const unsigned char * data, int width, int height, int channels, std::size_t rowBytes = 0)
+    {
+        rowBytes = rowBytes ? rowBytes : static_cast<std::size_t>(width) * channels;
+        levels.emplace_back();
+        Level & base = levels.back();
+        base.width = width;
+        base.height = height;
+        base.texels.resize(static_cast<std::size_t>(width) * height);
+
+        for (int y = 0; y != height; ++y)
+        {
+            const unsigned char * row = data + y * rowBytes;
+
+            for (int x = 0; x != width; ++x)
+            {
+                const unsigned char * texel = row + x * channels;
+                base.texels[static_cast<std::size_t>(y) * width + x] =
+                        glm::vec4(texel[0], texel[1], texel[2], channels == 4 ? texel[3] : 255) * (1.0f / 255.0f);
+            }
+        }
+
+        // glGenerateMipmap: each level averages 2x2 texels of the one before
+        while (levels.back().width > 1 || levels.back().height > 1)
+        {
+            const Level & src = levels.back();
+            Level dst;
+            dst.width = std::max(1, src.width / 2);
+            dst.height = std::max(1, src.height / 2);
+            dst.texels.resize(static_cast<std::size_t>(dst.width) * dst.height);
+
+            for (int y = 0; y != dst.height; ++y)
+            {
+                int y0 = std::min(2 * y, src.height - 1);
+                int y1 = std::min(2 * y + 1, src.height - 1);
+
+                for (int x = 0; x != dst.width; ++x)
+                {
+                    int x0 = std::min(2 * x, src.width - 1);
+                    int x1 = std::min(2 * x + 1, src.width - 1);
+                    dst.texels[static_cast<std::size_t>(y) * dst.width + x] =
+                            (src.at(x0, y0) + src.at(x1, y0) + src.at(x0, y1) + src.at(x1, y1)) * 0.25f;
+                }
+            }
+
+            levels.push_back(std::move(dst));
+        }
+    }
+
+    bool empty() const
+    {
+        return levels.empty();
+    }
+
+    // dx and dy are the screen-space derivatives of uv, which select the level as the GL does
+    glm::vec4 sample(const glm::vec2 & uv, const glm::vec2 & dx, const glm::vec2 & dy) const
+    {
+        glm::vec2 size(static_cast<float>(levels[0].width), static_cast<float>(levels[0].height));
+        float rho = std::max(glm::length(dx * size), glm::length(dy * size));
+        float lod = rho > 1.0f ? std::log2(rho) : 0.0f;
+
+        if (lod <= 0.0f)
+        {
+            return bilinear(levels[0], uv);
+        }
+
+        auto last = static_cast<float>(levels.size() - 1);
+        lod = std::min(lod, last);
+        auto level = static_cast<std::size_t>(lod);
+        float t = lod - static_cast<float>(level);
+
+        if (t == 0.0f || level + 1 == levels.size())
+        {
+            return bilinear(levels[level], uv);
+        }
+
+        return glm::mix(bilinear(levels[level], uv), bilinear(levels[level + 1], uv), t);
+    }
+
+private:
+    struct Level
+    {
+        int width;
+        int height;
+        std::vector<glm::vec4> texels;
+
+        const glm::vec4 & at(int x, int y) const
+        {
+            return texels[static_cast<std::size_t>(y) * width + x];
+        }
+    };
+
+    static glm::vec4 bilinear(const Level & level, const glm::vec2 & uv)
+    {
+        float x = uv.x * static_cast<float>(level.width) - 0.5f;
+        float y = uv.y * static_cast<float>(level.height) - 0.5f;
+        float fx = std::floor(x);
+        float fy = std::floor(y);
+        float tx = x - fx;
+        float ty = y - fy;
+
+        int x0 = wrap(static_cast<int>(fx), level.width);
+        int x1 = wrap(x0 + 1, level.width);
+        int y0 = wrap(static_cast<int>(fy), level.height);
+        int y1 = wrap(y0 + 1, level.height);
+
+        return glm::mix(glm::mix(level.at(x0, y0), level.at(x1, y0), tx),
+                        glm::mix(level.at(x0, y1), level.at(x1, y1), tx), ty);
+    }
+
+    static int wrap(int i, int size)
+    {
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+
+private:
+    std::vector<Level> levels;
+};
+
+
+// RGBA8 color and float depth, bottom row first. A color texel is laid out as glReadPixels with GL_RGBA and
+// GL_UNSIGNED_BYTE writes it, so both can be compared byte for byte.
+class SoftFramebuffer
+{
+public:
+    SoftFramebuffer(int width, int height) :
+            width(width),
+            height(height),
+            color(static_cast<std::size_t>(width) * height),
+            depth(static_cast<std::size_t>(width) * height)
+    {
+    }
+
+    void clear(const glm::vec4 & clearColor, float clearDepth = 1.0f)
+    {
+        std::fill(color.begin(), color.end(), pack(clearColor));
+        std::fill(depth.begin(), depth.end(), clearDepth);
+    }
+
+    int getWidth() const
+    {
+        return width;
+    }
+
+    int getHeight() const
+    {
+        return height;
+    }
+
+    std::uint32_t * getColor()
+    {
+        return color.data();
+    }
+
+    const std::uint32_t * getColor() const
+    {
+        return color.data();
+    }
+
+    float * getDepth()
+    {
+        return depth.data();
+    }
+
+    // as the GL converts a float color to an 8-bit normalized one
+    static std::uint32_t pack(const glm::vec4 & c)
+    {
+        auto channel = [](float v)
+        {
+            return static_cast<std::uint32_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+        };
+
+        return channel(c.x) | channel(c.y) << 8 | channel(c.z) << 16 | channel(c.w) << 24;
+    }
+
+private:
+    int width;
+    int height;
+    std::vector<std::uint32_t> color;
+    std::vector<float> depth;
+};
+
+
+// The program of samples 07 to 09 (09_vert_shader.glsl with 07_frag_shader.glsl), expressed in C++.
+struct SoftProgram
+{
+    glm::mat4 projection {1.0f};
+    glm::mat4 view {1.0f};
+    glm::mat4 model {1.0f};
+    const SoftTexture * texture1 {nullptr};
+    const SoftTexture * texture2 {nullptr};
+
+    // vertex shader: aPos and aTexCoord in, gl_Position out, TexCoord into texCoord
+    glm::vec4 vertex(const glm::vec3 & aPos, const glm::vec2 & aTexCoord, glm::vec2 & texCoord) const
+    {
+        texCoord = glm::vec2(aTexCoord.x, 1.0f - aTexCoord.y);
+        return projection * view * model * glm::vec4(aPos, 1.0f);
+    }
+
+    // fragment shader; dx and dy are the derivatives of TexCoord across the pixel quad
+    glm::vec4 fragment(const glm::vec2 & texCoord, const glm::vec2 & dx, const glm::vec2 & dy) const
+    {
+        // linearly interpolate between both textures (20% container, 80% awesomeface)
+        return glm::mix(texture1->sample(texCoord, dx, dy), texture2->sample(texCoord, dx, dy), 0.8f);
+    }
+};
+
+
+// A multi-threaded, tile-based rasterizer implementing the part of the pipeline the samples use, as a
+// deterministic reference that needs no GPU.
+//
+// draw() runs the vertex stage and triangle setup at once, in parallel over the triangles: clipping against the
+// near and far planes, the viewport transform and the plane equations of depth and the perspective-divided
+// attributes. finish() bins the triangles into square tiles and rasterizes the tiles in parallel; each tile walks
+// its triangles in submission order, in 2x2 pixel quads (four SIMD lanes) whose differences give the texture
+// derivatives. The image is independent of the thread count, so it can be hashed or compared exactly.
+// Pipeline state as in the samples: filled triangles without face culling, depth test GL_LESS when enabled,
+// depth range [0, 1], pixel centers at half-integers and a top-left fill rule.
+class SoftRasterizer
+{
+public:
+    explicit SoftRasterizer(JobSystem & jobSystem, int tileSize = 64) :
+            jobSystem(jobSystem),
+            tileSize(std::max(2, tileSize / 2 * 2))
+    {
+    }
+
+    SoftRasterizer(const SoftRasterizer &) = delete;
+
+    SoftRasterizer & operator=(const SoftRasterizer &) = delete;
+
+    // starts a frame into target; clearing it is up to the caller
+    void begin(SoftFramebuffer & target)
+    {
+        framebuffer = &target;
+        states.clear();
+        triangles.clear();
+    }
+
+    // glEnable / glDisable(GL_DEPTH_TEST) for the following draws
+    void setDepthTest(bool enabled)
+    {
+        depthTest = enabled;
+    }
+
+    // glDrawArrays (indices == nullptr) or glDrawElements of GL_TRIANGLES with the given program. vertices holds
+    // 5 floats per vertex, aPos then aTexCoord, as in the samples' vertex buffers; count is a number of vertices
+    // or indices. The vertex data must stay valid until finish().
+    void draw(const SoftProgram & program, const float * vertices, const unsigned int * indices, int first, int count)
+    {
+        std::size_t triangleCount = static_cast<std::size_t>(count) / 3;
+        std::size_t base = triangles.size();
+        auto state = static_cast<std::uint32_t>(states.size());
+        states.push_back({program, depthTest});
+
+        // a clipped triangle becomes up to three
+        triangles.resize(base + 3 * triangleCount);
+
+        jobSystem.parallelFor(0, triangleCount, 256, [&](std::size_t firstTriangle, std::size_t lastTriangle)
+        {
+            for (std::size_t t = firstTriangle; t != lastTriangle; ++t)
+            {
+                ClipVertex corners[3];
+
+                for (int k = 0; k != 3; ++k)
+                {
+                    std::size_t i = static_cast<std::size_t>(first) + 3 * t + k;
+                    const float * v = vertices + 5 * static_cast<std::size_t>(indices ? indices[i] : i);
+                    corners[k].position = program.vertex(glm::vec3(v[0], v[1], v[2]), glm::vec2(v[3], v[4]),
+                                                         corners[k].texCoord);
+                }
+
+                setup(corners, state, &triangles[base + 3 * t]);
+            }
+        });
+    }
+
+    // rasterizes everything drawn since begin() into the target
+    void finish()
+    {
+        int width = framebuffer->getWidth();
+        int height = framebuffer->getHeight();
+        tilesX = (width + tileSize - 1) / tileSize;
+        int tilesY = (height + tileSize - 1) / tileSize;
+        bins.resize(static_cast<std::size_t>(tilesX) * tilesY);
+
+        for (std::vector<std::uint32_t> & bin : bins)
+        {
+            bin.clear();
+        }
+
+        // binning in submission order keeps every tile's list in that order
+        for (std::size_t i = 0; i != triangles.size(); ++i)
+        {
+            const Triangle & triangle = triangles[i];
+
+            if (!triangle.valid)
+            {
+                continue;
+            }
+
+            for (int ty = triangle.minY / tileSize; ty <= triangle.maxY / tileSize; ++ty)
+            {
+                for (int tx = triangle.minX / tileSize; tx <= triangle.maxX / tileSize; ++tx)
+                {
+                    bins[static_cast<std::size_t>(ty) * tilesX + tx].push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+        }
+
+        jobSystem.parallelFor(0, bins.size(), 1, [this](std::size_t firstTile, std::size_t lastTile)
+        {
+            for (std::size_t tile = firstTile; tile != lastTile; ++tile)
+            {
+                rasterizeTile(tile);
+            }
+        });
+
+        states.clear();
+        triangles.clear();
+    }
+
+private:
+    struct ClipVertex
+    {
+        glm::vec4 position;
+        glm::vec2 texCoord;
+    };
+
+    // a triangle ready to rasterize: edge functions and attribute planes, all of the form a * x + b * y + c
+    struct Triangle
+    {
+        bool valid;
+        std::uint32_t state;
+        int minX, minY, maxX, maxY;     // pixel bounds, inclusive
+        float edgeA[3], edgeB[3], edgeC[3];
+        bool edgeTopLeft[3];
+        glm::vec3 depth;                // window depth
+        glm::vec3 invW;                 // 1 / w
+        glm::vec3 uOverW;
+        glm::vec3 vOverW;
+    };
+
+    struct DrawState
+    {
+        SoftProgram program;
+        bool depthTest;
+    };
+
+    // clips against -w <= z <= w and writes up to three triangles into out, marking unused slots invalid
+    void setup(const ClipVertex (& corners)[3], std::uint32_t state, Triangle * out) const
+    {
+        ClipVertex polygon[5] = {corners[0], corners[1], corners[2]};
+        int size = 3;
+
+        for (float side : {1.0f, -1.0f})
+        {
+            ClipVertex clipped[5];
+            int clippedSize = 0;
+
+            for (int i = 0; i != size; ++i)
+            {
+                const ClipVertex & a = polygon[i];
+                const ClipVertex & b = polygon[(i + 1) % size];
+
+                // distance inside the plane z = -w (side 1) or z = w (side -1)
+                float da = a.position.w + side * a.position.z;
+                float db = b.position.w + side * b.position.z;
+
+                if (da >= 0.0f)
+                {
+                    clipped[clippedSize++] = a;
+                }
+
+                if ((da >= 0.0f) != (db >= 0.0f))
+                {
+                    float t = da / (da - db);
+                    clipped[clippedSize].position = glm::mix(a.position, b.position, t);
+                    clipped[clippedSize].texCoord = glm::mix(a.texCoord, b.texCoord, t);
+                    ++clippedSize;
+                }
+            }
+
+            std::copy(clipped, clipped + clippedSize, polygon);
+            size = clippedSize;
+        }
+
+        for (int i = 0; i != 3; ++i)
+        {
+            out[i].valid = i + 2 < size && setupTriangle(polygon[0], polygon[i + 1], polygon[i + 2], state, out[i]);
+        }
+    }
+
+    bool setupTriangle(const ClipVertex & v0, const ClipVertex & v1, const ClipVertex & v2, std::uint32_t state,
+                       Triangle & triangle) const
+    {
+        int width = framebuffer->getWidth();
+        int height = framebuffer->getHeight();
+        const ClipVertex * v[3] = {&v0, &v1, &v2};
+        float x[3];
+        float y[3];
+
+        for (int i = 0; i != 3; ++i)
+        {
+            float invW = 1.0f / v[i]->position.w;
+            x[i] = (v[i]->position.x * invW * 0.5f + 0.5f) * static_cast<float>(width);
+            y[i] = (v[i]->position.y * invW * 0.5f + 0.5f) * static_cast<float>(height);
+            triangle.depth[i] = v[i]->position.z * invW * 0.5f + 0.5f;
+            triangle.invW[i] = invW;
+            triangle.uOverW[i] = v[i]->texCoord.x * invW;
+            triangle.vOverW[i] = v[i]->texCoord.y * invW;
+        }
+
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+        if (area == 0.0f || !std::isfinite(area))
+        {
+            return false;
+        }
+
+        // both windings are drawn; clockwise ones are turned around so the inside is positive
+        if (area < 0.0f)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(triangle.depth[1], triangle.depth[2]);
+            std::swap(triangle.invW[1], triangle.invW[2]);
+            std::swap(triangle.uOverW[1], triangle.uOverW[2]);
+            std::swap(triangle.vOverW[1], triangle.vOverW[2]);
+            area = -area;
+        }
+
+        // clamped while still floats: vertices far off screen may be beyond the range of int
+        float minX = std::max(std::floor(std::min({x[0], x[1], x[2]})), 0.0f);
+        float minY = std::max(std::floor(std::min({y[0], y[1], y[2]})), 0.0f);
+        float maxX = std::min(std::ceil(std::max({x[0], x[1], x[2]})), static_cast<float>(width - 1));
+        float maxY = std::min(std::ceil(std::max({y[0], y[1], y[2]})), static_cast<float>(height - 1));
+
+        if (minX > maxX || minY > maxY)
+        {
+            return false;
+        }
+
+        triangle.minX = static_cast<int>(minX);
+        triangle.minY = static_cast<int>(minY);
+        triangle.maxX = static_cast<int>(maxX);
+        triangle.maxY = static_cast<int>(maxY);
+
+        // edge i runs from vertex i to vertex i + 1 and is positive on the inside (to its left)
+        for (int i = 0; i != 3; ++i)
+        {
+            int j = (i + 1) % 3;
+            float dx = x[j] - x[i];
+            float dy = y[j] - y[i];
+            triangle.edgeA[i] = -dy;
+            triangle.edgeB[i] = dx;
+            triangle.edgeC[i] = dy * x[i] - dx * y[i];
+
+            // pixel centers exactly on a left or top edge belong to this triangle
+            triangle.edgeTopLeft[i] = dy < 0.0f || (dy == 0.0f && dx < 0.0f);
+        }
+
+        // attributes as planes: the barycentric weight of vertex i is edge (i + 1) over the area
+        float invArea = 1.0f / area;
+
+        for (glm::vec3 * attribute : {&triangle.depth, &triangle.invW, &triangle.uOverW, &triangle.vOverW})
+        {
+            glm::vec3 value = *attribute;
+            glm::vec3 plane(0.0f);
+
+            for (int i = 0; i != 3; ++i)
+            {
+                int e = (i + 1) % 3;
+                plane.x += value[i] * triangle.edgeA[e] * invArea;
+                plane.y += value[i] * triangle.edgeB[e] * invArea;
+                plane.z += value[i] * triangle.edgeC[e] * invArea;
+            }
+
+            *attribute = plane;
+        }
+
+        triangle.state = state;
+
+        return true;
+    }
+
+    void rasterizeTile(std::size_t tile) const
+    {
+        int width = framebuffer->getWidth();
+        int height = framebuffer->getHeight();
+        int tileX0 = static_cast<int>(tile % tilesX) * tileSize;
+        int tileY0 = static_cast<int>(tile / tilesX) * tileSize;
+        int tileX1 = std::min(tileX0 + tileSize, width) - 1;
+        int tileY1 = std::min(tileY0 + tileSize, height) - 1;
+
+        std::uint32_t * color = framebuffer->getColor();
+        float * depthBuffer = framebuffer->getDepth();
+
+        for (std::uint32_t index : bins[tile])
+        {
+            const Triangle & triangle = triangles[index];
+            const DrawState & state = states[triangle.state];
+
+            // quads start at even coordinates, and tiles are even-sized, so no quad straddles two tiles
+            int x0 = std::max(triangle.minX, tileX0) & ~1;
+            int y0 = std::max(triangle.minY, tileY0) & ~1;
+            int x1 = std::min(triangle.maxX, tileX1);
+            int y1 = std::min(triangle.maxY, tileY1);
+
+            for (int y = y0; y <= y1; y += 2)
+            {
+                for (int x = x0; x <= x1; x += 2)
+                {
+                    // lanes: (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1)
+                    float z[4];
+                    float invW[4];
+                    float uOverW[4];
+                    float vOverW[4];
+                    int mask = coverage(triangle, static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f,
+                                        z, invW, uOverW, vOverW);
+
+                    // lanes outside the framebuffer
+                    if (x + 1 >= width)
+                    {
+                        mask &= ~0xA;
+                    }
+
+                    if (y + 1 >= height)
+                    {
+                        mask &= ~0xC;
+                    }
+
+                    if (!mask)
+                    {
+                        continue;
+                    }
+
+                    // all four lanes are interpolated, covered or not, as helper pixels for the derivatives
+                    glm::vec2 uv[4];
+
+                    for (int lane = 0; lane != 4; ++lane)
+                    {
+                        float w = 1.0f / invW[lane];
+                        uv[lane] = glm::vec2(uOverW[lane] * w, vOverW[lane] * w);
+                    }
+
+                    glm::vec2 dx = uv[1] - uv[0];
+                    glm::vec2 dy = uv[2] - uv[0];
+
+                    for (int lane = 0; lane != 4; ++lane)
+                    {
+                        if (!(mask & (1 << lane)))
+                        {
+                            continue;
+                        }
+
+                        std::size_t pixel = static_cast<std::size_t>(y + (lane >> 1)) * width + x + (lane & 1);
+
+                        if (state.depthTest)
+                        {
+                            if (!(z[lane] < depthBuffer[pixel]))
+                            {
+                                continue;
+                            }
+
+                            depthBuffer[pixel] = z[lane];
+                        }
+
+                        color[pixel] = SoftFramebuffer::pack(state.program.fragment(uv[lane], dx, dy));
+                    }
+                }
+            }
+        }
+    }
+
+    // coverage mask of the quad whose first pixel center is (px, py), with its interpolated plane values
+    static int coverage(const Triangle & t, float px, float py,
+                        float (& z)[4], float (& invW)[4], float (& uOverW)[4], float (& vOverW)[4])
+    {
+#ifdef LEARNOPENGL_SOFT_RASTERIZER_SSE
+        __m128 x = _mm_add_ps(_mm_set1_ps(px), _mm_setr_ps(0.0f, 1.0f, 0.0f, 1.0f));
+        __m128 y = _mm_add_ps(_mm_set1_ps(py), _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f));
+        __m128 zero = _mm_setzero_ps();
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+
+        for (int i = 0; i != 3; ++i)
+        {
+            __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.edgeA[i]), x),
+                                             _mm_mul_ps(_mm_set1_ps(t.edgeB[i]), y)),
+                                  _mm_set1_ps(t.edgeC[i]));
+            inside = _mm_and_ps(inside, t.edgeTopLeft[i] ? _mm_cmpge_ps(e, zero) : _mm_cmpgt_ps(e, zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+
+        if (mask)
+        {
+            auto plane = [&x, &y](const glm::vec3 & p, float (& out)[4])
+            {
+                _mm_storeu_ps(out, _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.x), x),
+                                                         _mm_mul_ps(_mm_set1_ps(p.y), y)),
+                                              _mm_set1_ps(p.z)));
+            };
+
+            plane(t.depth, z);
+            plane(t.invW, invW);
+            plane(t.uOverW, uOverW);
+            plane(t.vOverW, vOverW);
+        }
+
+        return mask;
+#else
+        int mask = 0;
+
+        for (int lane = 0; lane != 4; ++lane)
+        {
+            float x = px + static_cast<float>(lane & 1);
+            float y = py + static_cast<float>(lane >> 1);
+            bool inside = true;
+
+            for (int i = 0; i != 3; ++i)
+            {
+                float e = t.edgeA[i] * x + t.edgeB[i] * y + t.edgeC[i];
+                inside = inside && (t.edgeTopLeft[i] ? e >= 0.0f : e > 0.0f);
+            }
+
+            mask |= inside ? 1 << lane : 0;
+            z[lane] = t.depth.x * x + t.depth.y * y + t.depth.z;
+            invW[lane] = t.invW.x * x + t.invW.y * y + t.invW.z;
+            uOverW[lane] = t.uOverW.x * x + t.uOverW.y * y + t.uOverW.z;
+            vOverW[lane] = t.vOverW.x * x + t.vOverW.y * y + t.vOverW.z;
+        }
+
+        return mask;
+#endif
+    }
+
+private:
+    JobSystem & jobSystem;
+    int tileSize;
+    int tilesX {0};
+
+    SoftFramebuffer * framebuffer {nullptr};
+    bool depthTest {false};
+
+    std::vector<DrawState> states;
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<std::uint32_t>> bins;
+};
+
+#endif // LEARNOPENGL_SOFT_RASTERIZER_H
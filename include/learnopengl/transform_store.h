@@ -0,0 +1,301 @@
+#ifndef LEARNOPENGL_TRANSFORM_STORE_H
+#define LEARNOPENGL_TRANSFORM_STORE_H
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LEARNOPENGL_TRANSFORM_SSE
+#endif
+
+
+// Transform components stored as structure-of-arrays, with parenting.
+//
+// Every field lives in its own array indexed by the transform's handle. A transform is created after its parent,
+// so the arrays are always in topological order and one forward pass updates the whole hierarchy: a transform is
+// recomputed when it or any ancestor changed since the last update(), everything else is left alone.
+// The update is split into two batch passes: local matrices (independent, 4 at a time with SSE) and then
+// local-to-world products in hierarchy order (SSE 4x4 products).
+class TransformStore
+{
+public:
+    using Handle = std::uint32_t;
+
+    static constexpr Handle None = 0xFFFFFFFFu;
+
+public:
+    void reserve(std::size_t count)
+    {
+        positions.reserve(count);
+        rotations.reserve(count);
+        scales.reserve(count);
+        parents.reserve(count);
+        worlds.reserve(count);
+        dirty.reserve(count);
+    }
+
+    // parent must already exist (or be None for a root)
+    Handle create(Handle parent = None,
+                  const glm::vec3 & position = glm::vec3(0.0f),
+                  const glm::quat & rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                  const glm::vec3 & scale = glm::vec3(1.0f))
+    {
+        if (parent != None && parent >= positions.size())
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "parent " << parent << " is not an existing transform!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        positions.push_back(position);
+        rotations.push_back(rotation);
+        scales.push_back(scale);
+        parents.push_back(parent);
+        worlds.emplace_back(1.0f);
+        dirty.push_back(1);
+
+        return static_cast<Handle>(positions.size() - 1);
+    }
+
+    void clear()
+    {
+        positions.clear();
+        rotations.clear();
+        scales.clear();
+        parents.clear();
+        worlds.clear();
+        dirty.clear();
+    }
+
+    std::size_t size() const
+    {
+        return positions.size();
+    }
+
+    void setPosition(Handle handle, const glm::vec3 & position)
+    {
+        positions[handle] = position;
+        dirty[handle] = 1;
+    }
+
+    void setRotation(Handle handle, const glm::quat & rotation)
+    {
+        rotations[handle] = rotation;
+        dirty[handle] = 1;
+    }
+
+    void setScale(Handle handle, const glm::vec3 & scale)
+    {
+        scales[handle] = scale;
+        dirty[handle] = 1;
+    }
+
+    const glm::vec3 & getPosition(Handle handle) const
+    {
+        return positions[handle];
+    }
+
+    const glm::quat & getRotation(Handle handle) const
+    {
+        return rotations[handle];
+    }
+
+    const glm::vec3 & getScale(Handle handle) const
+    {
+        return scales[handle];
+    }
+
+    Handle getParent(Handle handle) const
+    {
+        return parents[handle];
+    }
+
+    // valid after update()
+    const glm::mat4 & getWorld(Handle handle) const
+    {
+        return worlds[handle];
+    }
+
+    // all world matrices, contiguous and indexed by handle, e.g. for an instance buffer upload
+    const glm::mat4 * getWorldMatrices() const
+    {
+        return worlds.data();
+    }
+
+    // recomputes the dirty transforms and their descendants, returns how many were recomputed
+    std::size_t update()
+    {
+        // propagate dirtiness down; parents precede their children, so one forward pass reaches every descendant
+        batch.clear();
+
+        for (std::size_t i = 0; i != parents.size(); ++i)
+        {
+            if (parents[i] != None && dirty[parents[i]])
+            {
+                dirty[i] = 1;
+            }
+
+            if (dirty[i])
+            {
+                batch.push_back(static_cast<Handle>(i));
+            }
+        }
+
+        locals.resize(batch.size());
+        composeLocals();
+
+        for (std::size_t b = 0; b != batch.size(); ++b)
+        {
+            Handle i = batch[b];
+
+            if (parents[i] == None)
+            {
+                worlds[i] = locals[b];
+            }
+            else
+            {
+                multiply(worlds[parents[i]], locals[b], worlds[i]);
+            }
+
+            dirty[i] = 0;
+        }
+
+        return batch.size();
+    }
+
+private:
+    // local = translate * rotate * scale for every transform in the batch
+    void composeLocals()
+    {
+        std::size_t b = 0;
+
+#ifdef LEARNOPENGL_TRANSFORM_SSE
+        for (; b + 4 <= batch.size(); b += 4)
+        {
+            const Handle * h = &batch[b];
+
+            // gather 4 transforms into one register per component
+            __m128 qx = _mm_setr_ps(rotations[h[0]].x, rotations[h[1]].x, rotations[h[2]].x, rotations[h[3]].x);
+            __m128 qy = _mm_setr_ps(rotations[h[0]].y, rotations[h[1]].y, rotations[h[2]].y, rotations[h[3]].y);
+            __m128 qz = _mm_setr_ps(rotations[h[0]].z, rotations[h[1]].z, rotations[h[2]].z, rotations[h[3]].z);
+            __m128 qw = _mm_setr_ps(rotations[h[0]].w, rotations[h[1]].w, rotations[h[2]].w, rotations[h[3]].w);
+            __m128 sx = _mm_setr_ps(scales[h[0]].x, scales[h[1]].x, scales[h[2]].x, scales[h[3]].x);
+            __m128 sy = _mm_setr_ps(scales[h[0]].y, scales[h[1]].y, scales[h[2]].y, scales[h[3]].y);
+            __m128 sz = _mm_setr_ps(scales[h[0]].z, scales[h[1]].z, scales[h[2]].z, scales[h[3]].z);
+            __m128 px = _mm_setr_ps(positions[h[0]].x, positions[h[1]].x, positions[h[2]].x, positions[h[3]].x);
+            __m128 py = _mm_setr_ps(positions[h[0]].y, positions[h[1]].y, positions[h[2]].y, positions[h[3]].y);
+            __m128 pz = _mm_setr_ps(positions[h[0]].z, positions[h[1]].z, positions[h[2]].z, positions[h[3]].z);
+
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 two = _mm_set1_ps(2.0f);
+            __m128 xx = _mm_mul_ps(qx, qx);
+            __m128 yy = _mm_mul_ps(qy, qy);
+            __m128 zz = _mm_mul_ps(qz, qz);
+            __m128 xy = _mm_mul_ps(qx, qy);
+            __m128 xz = _mm_mul_ps(qx, qz);
+            __m128 yz = _mm_mul_ps(qy, qz);
+            __m128 wx = _mm_mul_ps(qw, qx);
+            __m128 wy = _mm_mul_ps(qw, qy);
+            __m128 wz = _mm_mul_ps(qw, qz);
+
+            // rotation matrix entries, column-major, times the scale of their column
+            __m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+            __m128 m01 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, wz)));
+            __m128 m02 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, wy)));
+            __m128 m10 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, wz)));
+            __m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+            __m128 m12 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, wx)));
+            __m128 m20 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, wy)));
+            __m128 m21 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, wx)));
+            __m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+            __m128 w0 = _mm_setzero_ps();
+            __m128 w1 = _mm_setzero_ps();
+            __m128 w2 = _mm_setzero_ps();
+            __m128 w3 = one;
+
+            // transpose from one register per entry to one register per matrix column
+            _MM_TRANSPOSE4_PS(m00, m01, m02, w0);
+            _MM_TRANSPOSE4_PS(m10, m11, m12, w1);
+            _MM_TRANSPOSE4_PS(m20, m21, m22, w2);
+            _MM_TRANSPOSE4_PS(px, py, pz, w3);
+
+            __m128 columns[4][4] = {{m00, m10, m20, px},
+                                    {m01, m11, m21, py},
+                                    {m02, m12, m22, pz},
+                                    {w0,  w1,  w2,  w3}};
+
+            for (int k = 0; k != 4; ++k)
+            {
+                float * m = &locals[b + k][0][0];
+
+                for (int c = 0; c != 4; ++c)
+                {
+                    _mm_storeu_ps(m + 4 * c, columns[k][c]);
+                }
+            }
+        }
+#endif
+
+        for (; b != batch.size(); ++b)
+        {
+            Handle i = batch[b];
+            glm::mat4 local = glm::mat4_cast(rotations[i]);
+            local[0] *= scales[i].x;
+            local[1] *= scales[i].y;
+            local[2] *= scales[i].z;
+            local[3] = glm::vec4(positions[i], 1.0f);
+            locals[b] = local;
+        }
+    }
+
+    // out = a * b
+    static void multiply(const glm::mat4 & a, const glm::mat4 & b, glm::mat4 & out)
+    {
+#ifdef LEARNOPENGL_TRANSFORM_SSE
+        const float * pa = &a[0][0];
+        const float * pb = &b[0][0];
+        float * po = &out[0][0];
+
+        __m128 a0 = _mm_loadu_ps(pa);
+        __m128 a1 = _mm_loadu_ps(pa + 4);
+        __m128 a2 = _mm_loadu_ps(pa + 8);
+        __m128 a3 = _mm_loadu_ps(pa + 12);
+
+        for (int c = 0; c != 4; ++c)
+        {
+            __m128 column = _mm_mul_ps(a0, _mm_set1_ps(pb[4 * c]));
+            column = _mm_add_ps(column, _mm_mul_ps(a1, _mm_set1_ps(pb[4 * c + 1])));
+            column = _mm_add_ps(column, _mm_mul_ps(a2, _mm_set1_ps(pb[4 * c + 2])));
+            column = _mm_add_ps(column, _mm_mul_ps(a3, _mm_set1_ps(pb[4 * c + 3])));
+            _mm_storeu_ps(po + 4 * c, column);
+        }
+#else
+        out = a * b;
+#endif
+    }
+
+private:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<Handle> parents;
+    std::vector<glm::mat4> worlds;
+    std::vector<std::uint8_t> dirty;
+
+    // scratch of update(): the transforms to recompute, in hierarchy order, and their local matrices
+    std::vector<Handle> batch;
+    std::vector<glm::mat4> locals;
+};
+
+#endif // LEARNOPENGL_TRANSFORM_STORE_H
@@ -0,0 +1,131 @@
+#ifndef LEARNOPENGL_UNIFORMS_H
+#define LEARNOPENGL_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include <iostream>
+
+
+// Typed uniform handles used by the structs that shader_reflect generates for each program.
+//
+// The location is looked up once when the struct is built for a linked program; set() is a direct glUniform* call.
+// A name the linked program does not expose (misspelt in the shader, or optimized away) is reported right away
+// instead of being silently ignored on every set().
+template <typename T>
+class Uniform
+{
+public:
+    Uniform(unsigned int program, const char * name) : location(glGetUniformLocation(program, name))
+    {
+        if (location < 0)
+        {
+            std::cout << "[WARNING] uniform \"" << name << "\" is not active in program " << program << std::endl;
+        }
+    }
+
+    // the program must be in use
+    void set(const T & value) const;
+
+    int getLocation() const
+    {
+        return location;
+    }
+
+private:
+    int location;
+};
+
+template <>
+inline void Uniform<bool>::set(const bool & value) const
+{
+    glUniform1i(location, static_cast<int>(value));
+}
+
+template <>
+inline void Uniform<int>::set(const int & value) const
+{
+    glUniform1i(location, value);
+}
+
+template <>
+inline void Uniform<unsigned int>::set(const unsigned int & value) const
+{
+    glUniform1ui(location, value);
+}
+
+template <>
+inline void Uniform<float>::set(const float & value) const
+{
+    glUniform1f(location, value);
+}
+
+template <>
+inline void Uniform<glm::vec2>::set(const glm::vec2 & value) const
+{
+    glUniform2fv(location, 1, &value[0]);
+}
+
+template <>
+inline void Uniform<glm::vec3>::set(const glm::vec3 & value) const
+{
+    glUniform3fv(location, 1, &value[0]);
+}
+
+template <>
+inline void Uniform<glm::vec4>::set(const glm::vec4 & value) const
+{
+    glUniform4fv(location, 1, &value[0]);
+}
+
+template <>
+inline void Uniform<glm::ivec2>::set(const glm::ivec2 & value) const
+{
+    glUniform2i(location, value.x, value.y);
+}
+
+template <>
+inline void Uniform<glm::ivec3>::set(const glm::ivec3 & value) const
+{
+    glUniform3i(location, value.x, value.y, value.z);
+}
+
+template <>
+inline void Uniform<glm::ivec4>::set(const glm::ivec4 & value) const
+{
+    glUniform4i(location, value.x, value.y, value.z, value.w);
+}
+
+template <>
+inline void Uniform<glm::mat2>::set(const glm::mat2 & value) const
+{
+    glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+template <>
+inline void Uniform<glm::mat3>::set(const glm::mat3 & value) const
+{
+    glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+template <>
+inline void Uniform<glm::mat4>::set(const glm::mat4 & value) const
+{
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+
+// samplers are set to the texture unit they read from
+struct Sampler
+{
+    int unit;
+};
+
+template <>
+inline void Uniform<Sampler>::set(const Sampler & value) const
+{
+    glUniform1i(location, value.unit);
+}
+
+#endif // LEARNOPENGL_UNIFORMS_H
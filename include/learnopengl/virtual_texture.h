@@ -0,0 +1,683 @@
+#ifndef LEARNOPENGL_VIRTUAL_TEXTURE_H
+#define LEARNOPENGL_VIRTUAL_TEXTURE_H
+
+#include <glad/glad.h>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "learnopengl/shader.h"
+
+
+// Tiled virtual texture for images that do not fit into video memory.
+//
+// Offline, VirtualTexture::bake cuts an image and its mip chain into fixed-size pages (with a replicated border
+// for bilinear filtering) and writes them into a page file. At runtime only the pages requested by the feedback
+// pass are streamed in by background I/O threads, uploaded into a physical page atlas managed as an LRU cache,
+// and addressed through a mipmapped indirection texture (one texel per virtual page).
+class VirtualTexture
+{
+public:
+    // layout of the page file header, followed by all pages of level 0, level 1, ... in row-major order
+    struct PageFileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t tileSize;
+        std::uint32_t border;
+        std::uint32_t levels;
+        std::uint32_t virtualPages;  // the virtual page grid of level 0 is virtualPages x virtualPages (power of two)
+    };
+
+    // identifies one page of the virtual mip chain
+    struct PageId
+    {
+        int x;
+        int y;
+        int level;
+
+        bool operator==(const PageId & rhs) const
+        {
+            return x == rhs.x && y == rhs.y && level == rhs.level;
+        }
+    };
+
+    struct PageIdHash
+    {
+        std::size_t operator()(const PageId & id) const
+        {
+            return (static_cast<std::size_t>(id.level) << 48) ^
+                   (static_cast<std::size_t>(id.y) << 24) ^
+                   static_cast<std::size_t>(id.x);
+        }
+    };
+
+public:
+    // cuts the image at imagePath into pages and writes the page file
+    static void bake(const char * imagePath, const char * pageFilePath, int tileSize = 128, int border = 1)
+    {
+        cv::Mat level = cv::imread(imagePath, cv::IMREAD_COLOR);
+
+        if (level.empty())
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "cv::imread failed!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        PageFileHeader header {};
+        std::memcpy(header.magic, "VTPF", 4);
+        header.version = 1;
+        header.width = level.cols;
+        header.height = level.rows;
+        header.tileSize = tileSize;
+        header.border = border;
+
+        int pagesNeeded = std::max((level.cols + tileSize - 1) / tileSize, (level.rows + tileSize - 1) / tileSize);
+        header.virtualPages = 1;
+        header.levels = 1;
+
+        while (static_cast<int>(header.virtualPages) < pagesNeeded)
+        {
+            header.virtualPages <<= 1;
+            ++header.levels;
+        }
+
+        std::ofstream fout {pageFilePath, std::ofstream::out | std::ofstream::binary};
+
+        if (!fout)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Page file not successfully opened for writing!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(PageFileHeader));
+
+        for (unsigned int l = 0; l != header.levels; ++l)
+        {
+            if (l != 0)
+            {
+                cv::resize(level, level, cv::Size(std::max(1, level.cols / 2), std::max(1, level.rows / 2)),
+                           0, 0, cv::INTER_AREA);
+            }
+
+            int tilesX = tilesAlong(header.width, l, tileSize);
+            int tilesY = tilesAlong(header.height, l, tileSize);
+
+            // pad to whole tiles plus the border ring, replicating the image edge
+            cv::Mat padded;
+            cv::copyMakeBorder(level, padded,
+                               border, border + tilesY * tileSize - level.rows,
+                               border, border + tilesX * tileSize - level.cols,
+                               cv::BORDER_REPLICATE);
+
+            for (int y = 0; y != tilesY; ++y)
+            {
+                for (int x = 0; x != tilesX; ++x)
+                {
+                    cv::Mat page = padded(cv::Rect(x * tileSize, y * tileSize,
+                                                   tileSize + 2 * border, tileSize + 2 * border)).clone();
+                    fout.write(reinterpret_cast<const char *>(page.data),
+                               static_cast<std::streamsize>(page.total() * page.elemSize()));
+                }
+            }
+        }
+    }
+
+    VirtualTexture(const char * pageFilePath, int physicalPagesPerSide = 16, int ioThreads = 2) :
+            pageFilePath(pageFilePath),
+            physicalPagesPerSide(physicalPagesPerSide)
+    {
+        std::ifstream fin {pageFilePath, std::ifstream::in | std::ifstream::binary};
+
+        if (!fin || !fin.read(reinterpret_cast<char *>(&header), sizeof(PageFileHeader)) ||
+            std::memcmp(header.magic, "VTPF", 4) != 0)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Page file not successfully read!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        pageStride = static_cast<int>(header.tileSize + 2 * header.border);
+        pageBytes = static_cast<std::size_t>(pageStride) * pageStride * 3;
+
+        levelOffsets.resize(header.levels + 1, 0);
+
+        for (unsigned int l = 0; l != header.levels; ++l)
+        {
+            levelOffsets[l + 1] = levelOffsets[l] +
+                                  tilesAlong(header.width, l, header.tileSize) *
+                                  tilesAlong(header.height, l, header.tileSize);
+        }
+
+        createTextures();
+
+        // the single page of the coarsest level is loaded synchronously and never evicted,
+        // so every lookup always has a resident fallback
+        PageId root {0, 0, static_cast<int>(header.levels) - 1};
+        std::vector<unsigned char> pixels(pageBytes);
+        fin.seekg(static_cast<std::streamoff>(pageOffset(root)));
+        fin.read(reinterpret_cast<char *>(pixels.data()), static_cast<std::streamsize>(pageBytes));
+        uploadPage(root, pixels);
+        pinned = resident.at(root).slot;
+        indirectionDirty = true;
+
+        for (int i = 0; i != ioThreads; ++i)
+        {
+            workers.emplace_back(&VirtualTexture::ioLoop, this);
+        }
+    }
+
+    VirtualTexture(const VirtualTexture &) = delete;
+
+    VirtualTexture & operator=(const VirtualTexture &) = delete;
+
+    ~VirtualTexture()
+    {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            stopping = true;
+        }
+
+        requestCondition.notify_all();
+
+        for (std::thread & worker : workers)
+        {
+            worker.join();
+        }
+
+        glDeleteTextures(1, &physicalTexture);
+        glDeleteTextures(1, &indirectionTexture);
+    }
+
+    // binds the physical page atlas and the indirection texture and points the sampler uniforms at them;
+    // uniforms are the generated uniforms of the sampling shader (VirtualTextureUniforms), which must be in use
+    template <typename SamplingUniforms>
+    void bind(const SamplingUniforms & uniforms, int physicalUnit = 0, int indirectionUnit = 1) const
+    {
+        glActiveTexture(GL_TEXTURE0 + physicalUnit);
+        glBindTexture(GL_TEXTURE_2D, physicalTexture);
+        glActiveTexture(GL_TEXTURE0 + indirectionUnit);
+        glBindTexture(GL_TEXTURE_2D, indirectionTexture);
+
+        uniforms.vtPhysical.set({physicalUnit});
+        uniforms.vtIndirection.set({indirectionUnit});
+        uniforms.vtPhysicalLayout.set(glm::vec4(static_cast<float>(header.tileSize),
+                                                static_cast<float>(header.border),
+                                                static_cast<float>(pageStride),
+                                                static_cast<float>(physicalPagesPerSide * pageStride)));
+        setUniforms(uniforms);
+    }
+
+    // uniforms shared by the feedback and the sampling shader, given as either's generated uniforms
+    template <typename Uniforms>
+    void setUniforms(const Uniforms & uniforms) const
+    {
+        float virtualSize = static_cast<float>(header.virtualPages * header.tileSize);
+        uniforms.vtVirtualPages.set(static_cast<float>(header.virtualPages));
+        uniforms.vtVirtualSize.set(virtualSize);
+        uniforms.vtMaxLevel.set(static_cast<float>(header.levels - 1));
+        uniforms.vtImageExtent.set(glm::vec2(static_cast<float>(header.width) / virtualSize,
+                                             static_cast<float>(header.height) / virtualSize));
+    }
+
+    // records that a page is needed this frame, queueing the load of non-resident pages
+    void request(const PageId & id)
+    {
+        if (id.level < 0 || id.level >= static_cast<int>(header.levels) ||
+            id.x < 0 || id.x >= tilesAlong(header.width, id.level, header.tileSize) ||
+            id.y < 0 || id.y >= tilesAlong(header.height, id.level, header.tileSize))
+        {
+            return;
+        }
+
+        auto it = resident.find(id);
+
+        if (it != resident.end())
+        {
+            // mark as most recently used
+            lru.splice(lru.begin(), lru, it->second.lruPos);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(requestMutex);
+
+        if (pending.insert(id).second)
+        {
+            requestQueue.push(id);
+            requestCondition.notify_one();
+        }
+    }
+
+    // consumes the RGBA16UI texels written by the feedback shader: (page x, page y, level, 1)
+    void requestFromFeedback(const std::uint16_t * texels, std::size_t texelCount)
+    {
+        std::unordered_set<PageId, PageIdHash> unique;
+
+        for (std::size_t i = 0; i != texelCount; ++i)
+        {
+            const std::uint16_t * t = texels + 4 * i;
+
+            if (t[3] != 0)
+            {
+                unique.insert({t[0], t[1], t[2]});
+            }
+        }
+
+        for (const PageId & id : unique)
+        {
+            request(id);
+
+            // also request the parent so a coarser fallback is streamed in early
+            if (id.level + 1 < static_cast<int>(header.levels))
+            {
+                request({id.x / 2, id.y / 2, id.level + 1});
+            }
+        }
+    }
+
+    // uploads at most maxUploads streamed pages and refreshes the indirection texture; call once per frame
+    void update(int maxUploads = 8)
+    {
+        std::vector<std::pair<PageId, std::vector<unsigned char>>> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+
+            while (!completed.empty() && static_cast<int>(ready.size()) < maxUploads)
+            {
+                ready.emplace_back(std::move(completed.front()));
+                completed.pop_front();
+            }
+        }
+
+        for (auto & page : ready)
+        {
+            uploadPage(page.first, page.second);
+
+            std::lock_guard<std::mutex> lock(requestMutex);
+            pending.erase(page.first);
+        }
+
+        if (!ready.empty())
+        {
+            indirectionDirty = true;
+        }
+
+        if (indirectionDirty)
+        {
+            updateIndirection();
+            indirectionDirty = false;
+        }
+    }
+
+    const PageFileHeader & getHeader() const
+    {
+        return header;
+    }
+
+    std::size_t getResidentPageCount() const
+    {
+        return resident.size();
+    }
+
+private:
+    struct ResidentPage
+    {
+        int slot;
+        std::list<PageId>::iterator lruPos;
+    };
+
+    static int tilesAlong(unsigned int extent, unsigned int level, unsigned int tileSize)
+    {
+        unsigned int levelExtent = std::max(1U, extent >> level);
+        return static_cast<int>((levelExtent + tileSize - 1) / tileSize);
+    }
+
+    std::uint64_t pageOffset(const PageId & id) const
+    {
+        int tilesX = tilesAlong(header.width, id.level, header.tileSize);
+        std::uint64_t index = levelOffsets[id.level] + static_cast<std::uint64_t>(id.y) * tilesX + id.x;
+        return sizeof(PageFileHeader) + index * pageBytes;
+    }
+
+    void createTextures()
+    {
+        int physicalSize = physicalPagesPerSide * pageStride;
+
+        glGenTextures(1, &physicalTexture);
+        glBindTexture(GL_TEXTURE_2D, physicalTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, physicalSize, physicalSize, 0, GL_BGR, GL_UNSIGNED_BYTE, nullptr);
+
+        // one RGBA8 texel per virtual page and level: (slot x, slot y, resident level, 255)
+        glGenTextures(1, &indirectionTexture);
+        glBindTexture(GL_TEXTURE_2D, indirectionTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(header.levels) - 1);
+
+        for (unsigned int l = 0; l != header.levels; ++l)
+        {
+            int size = static_cast<int>(header.virtualPages >> l);
+            glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+
+        indirection.resize(header.levels);
+
+        for (unsigned int l = 0; l != header.levels; ++l)
+        {
+            std::size_t size = header.virtualPages >> l;
+            indirection[l].assign(size * size * 4, 0);
+        }
+
+        for (int slot = physicalPagesPerSide * physicalPagesPerSide - 1; slot >= 0; --slot)
+        {
+            freeSlots.push_back(slot);
+        }
+    }
+
+    void uploadPage(const PageId & id, const std::vector<unsigned char> & pixels)
+    {
+        if (resident.count(id))
+        {
+            return;
+        }
+
+        int slot;
+
+        if (!freeSlots.empty())
+        {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            // evict the least recently used page, skipping the pinned root page
+            auto victim = std::prev(lru.end());
+
+            if (resident.at(*victim).slot == pinned)
+            {
+                --victim;
+            }
+
+            slot = resident.at(*victim).slot;
+            resident.erase(*victim);
+            lru.erase(victim);
+        }
+
+        lru.push_front(id);
+        resident.emplace(id, ResidentPage {slot, lru.begin()});
+
+        glBindTexture(GL_TEXTURE_2D, physicalTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0,
+                        (slot % physicalPagesPerSide) * pageStride, (slot / physicalPagesPerSide) * pageStride,
+                        pageStride, pageStride, GL_BGR, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    // every virtual page points to itself if resident, otherwise inherits its parent's mapping
+    void updateIndirection()
+    {
+        glBindTexture(GL_TEXTURE_2D, indirectionTexture);
+
+        for (int l = static_cast<int>(header.levels) - 1; l >= 0; --l)
+        {
+            int size = static_cast<int>(header.virtualPages >> l);
+            std::vector<unsigned char> & entries = indirection[l];
+
+            for (int y = 0; y != size; ++y)
+            {
+                for (int x = 0; x != size; ++x)
+                {
+                    unsigned char * entry = &entries[4 * (y * size + x)];
+                    auto it = resident.find({x, y, l});
+
+                    if (it != resident.end())
+                    {
+                        entry[0] = static_cast<unsigned char>(it->second.slot % physicalPagesPerSide);
+                        entry[1] = static_cast<unsigned char>(it->second.slot / physicalPagesPerSide);
+                        entry[2] = static_cast<unsigned char>(l);
+                        entry[3] = 255;
+                    }
+                    else
+                    {
+                        const unsigned char * parent = &indirection[l + 1][4 * ((y / 2) * (size / 2) + x / 2)];
+                        std::copy(parent, parent + 4, entry);
+                    }
+                }
+            }
+
+            glTexSubImage2D(GL_TEXTURE_2D, l, 0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, entries.data());
+        }
+    }
+
+    // background I/O: coarse levels are served first so fallbacks appear before detail
+    void ioLoop()
+    {
+        std::ifstream fin {pageFilePath, std::ifstream::in | std::ifstream::binary};
+
+        while (true)
+        {
+            PageId id {};
+
+            {
+                std::unique_lock<std::mutex> lock(requestMutex);
+                requestCondition.wait(lock, [this] { return stopping || !requestQueue.empty(); });
+
+                if (stopping)
+                {
+                    return;
+                }
+
+                id = requestQueue.top();
+                requestQueue.pop();
+            }
+
+            std::vector<unsigned char> pixels(pageBytes);
+            fin.seekg(static_cast<std::streamoff>(pageOffset(id)));
+
+            if (!fin.read(reinterpret_cast<char *>(pixels.data()), static_cast<std::streamsize>(pageBytes)))
+            {
+                fin.clear();
+                std::lock_guard<std::mutex> lock(requestMutex);
+                pending.erase(id);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.emplace_back(id, std::move(pixels));
+        }
+    }
+
+    struct CoarserFirst
+    {
+        bool operator()(const PageId & lhs, const PageId & rhs) const
+        {
+            return lhs.level < rhs.level;
+        }
+    };
+
+private:
+    std::string pageFilePath;
+    PageFileHeader header {};
+    std::vector<std::uint64_t> levelOffsets;
+    int pageStride {0};
+    std::size_t pageBytes {0};
+
+    // GPU side
+    int physicalPagesPerSide;
+    unsigned int physicalTexture {0};
+    unsigned int indirectionTexture {0};
+    std::vector<std::vector<unsigned char>> indirection;
+    bool indirectionDirty {false};
+
+    // page cache, touched by the render thread only
+    std::unordered_map<PageId, ResidentPage, PageIdHash> resident;
+    std::list<PageId> lru;
+    std::vector<int> freeSlots;
+    int pinned {-1};
+
+    // I/O
+    std::vector<std::thread> workers;
+    std::mutex requestMutex;
+    std::condition_variable requestCondition;
+    std::priority_queue<PageId, std::vector<PageId>, CoarserFirst> requestQueue;
+    std::unordered_set<PageId, PageIdHash> pending;
+    bool stopping {false};
+
+    std::mutex completedMutex;
+    std::list<std::pair<PageId, std::vector<unsigned char>>> completed;
+};
+
+
+// Renders the scene at reduced resolution into an integer target recording the virtual page each pixel needs,
+// and reads it back through a pair of pixel pack buffers so the CPU consumes the previous frame's result.
+class VirtualTextureFeedback
+{
+public:
+    VirtualTextureFeedback(int screenWidth, int screenHeight, int downscale = 8) :
+            downscale(downscale),
+            width(std::max(1, screenWidth / downscale)),
+            height(std::max(1, screenHeight / downscale))
+    {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+        glGenTextures(1, &colorTexture);
+        glBindTexture(GL_TEXTURE_2D, colorTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+
+        glGenRenderbuffers(1, &depthBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Feedback framebuffer is not complete!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        std::size_t bytes = static_cast<std::size_t>(width) * height * 4 * sizeof(std::uint16_t);
+        glGenBuffers(2, pbo);
+
+        for (unsigned int buffer : pbo)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    VirtualTextureFeedback(const VirtualTextureFeedback &) = delete;
+
+    VirtualTextureFeedback & operator=(const VirtualTextureFeedback &) = delete;
+
+    ~VirtualTextureFeedback()
+    {
+        glDeleteBuffers(2, pbo);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        glDeleteTextures(1, &colorTexture);
+        glDeleteFramebuffers(1, &fbo);
+    }
+
+    // binds the feedback target; the caller then draws the scene with the feedback shader, whose generated uniforms
+    // (VirtualTextureFeedbackUniforms) are given
+    template <typename FeedbackUniforms>
+    void begin(Shader & feedbackShader, const FeedbackUniforms & uniforms, const VirtualTexture & vt) const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+
+        GLuint clear[4] = {0, 0, 0, 0};
+        glClearBufferuiv(GL_COLOR, 0, clear);
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        feedbackShader.use();
+        vt.setUniforms(uniforms);
+
+        // derivatives are larger by the downscale factor at the reduced resolution
+        uniforms.vtFeedbackBias.set(-std::log2(static_cast<float>(downscale)));
+    }
+
+    // starts the asynchronous readback of this frame and hands last frame's result to the virtual texture
+    void end(VirtualTexture & vt, int screenWidth, int screenHeight)
+    {
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[frame % 2]);
+        glReadPixels(0, 0, width, height, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+
+        if (frame != 0)
+        {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[(frame + 1) % 2]);
+            auto * texels = static_cast<const std::uint16_t *>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+
+            if (texels)
+            {
+                vt.requestFromFeedback(texels, static_cast<std::size_t>(width) * height);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, screenWidth, screenHeight);
+
+        ++frame;
+    }
+
+private:
+    int downscale;
+    int width;
+    int height;
+
+    unsigned int fbo {0};
+    unsigned int colorTexture {0};
+    unsigned int depthBuffer {0};
+    unsigned int pbo[2] {0, 0};
+    unsigned long long frame {0};
+};
+
+#endif // LEARNOPENGL_VIRTUAL_TEXTURE_H
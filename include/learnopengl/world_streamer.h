@@ -0,0 +1,1013 @@
+#ifndef LEARNOPENGL_WORLD_STREAMER_H
+#define LEARNOPENGL_WORLD_STREAMER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "learnopengl/gl_resource.h"
+#include "learnopengl/mesh_simplifier.h"
+
+
+struct WorldStreamerSettings
+{
+    float loadRadius {160.0f};                  // chunks whose centre is closer to the camera are loaded
+    float unloadRadius {200.0f};                // and kept until they are farther than this
+    std::size_t memoryBudget {64u << 20};       // bytes of GPU memory for chunks, free pooled resources included
+    float viewWeight {1.0f};                    // a chunk behind the camera counts as 1 + viewWeight times as far
+    int uploadsPerFrame {2};                    // uploads, and downscales after reclaim(), per frame
+    int ioThreads {2};
+    int maxTextureReduction {2};                // halvings of the texture resolution reclaim() may go to
+};
+
+
+// Streams a world of square chunks (geometry and texture each) from disk around the camera.
+//
+// Offline, WorldStreamer::bake writes a world file: a header, one ChunkRecord per chunk, and per chunk its vertices,
+// indices and JPEG-encoded texture. At runtime update() queues the chunks within loadRadius of the camera, ordered
+// by distance and weighted towards the view direction; background I/O threads read and decode them, and the render
+// thread uploads a few per frame. Chunks beyond unloadRadius are unloaded, the gap between the radii keeping a chunk
+// at the edge from loading and unloading as the camera moves to and fro.
+//
+// The budget covers resident chunks and the free pooled resources. When an upload would exceed it, pooled resources
+// are deleted first, then the resident chunks of lower priority are evicted. A chunk that does not fit even so is
+// dropped and nothing of its priority or lower is queued again until a chunk leaves the unload radius.
+//
+// Unloaded chunks return their buffers to a GlBufferPool, their texture to a GlTexturePool and their vertex array to
+// a free list, and uploads take from these with glBufferSubData and glTexSubImage2D, so streaming at a steady state
+// allocates no GL objects. The buffer pool's power-of-two size classes let chunks of similar size share buffers.
+// All of them are GlResourceTracker objects, as geometry and texture.
+//
+// reclaim() and grant() let a GpuMemoryBudget move the budget below memoryBudget and back: under memory pressure the
+// pools go first, then texture resolution, and then the chunks of worst priority.
+class WorldStreamer
+{
+public:
+    struct WorldFileHeader
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t chunksX;
+        std::uint32_t chunksZ;
+        float chunkSize;
+    };
+
+    // one per chunk after the header, row-major
+    struct ChunkRecord
+    {
+        std::uint64_t offset;       // of the vertices, followed by the indices and the encoded texture
+        std::uint32_t vertexCount;
+        std::uint32_t indexCount;
+        std::uint32_t textureBytes;
+        float minHeight;
+        float maxHeight;
+    };
+
+    struct ChunkCoord
+    {
+        int x;
+        int z;
+
+        bool operator==(const ChunkCoord & rhs) const
+        {
+            return x == rhs.x && z == rhs.z;
+        }
+    };
+
+    struct ChunkCoordHash
+    {
+        std::size_t operator()(const ChunkCoord & coord) const
+        {
+            return (static_cast<std::size_t>(static_cast<std::uint32_t>(coord.x)) << 32) ^
+                   static_cast<std::uint32_t>(coord.z);
+        }
+    };
+
+    // what drawing a resident chunk needs; vertex positions are relative to origin
+    struct ResidentChunk
+    {
+        ChunkCoord coord;
+        glm::vec3 origin;
+        glm::vec3 center;           // of the bounding sphere
+        float radius;
+        unsigned int vertexArray;
+        unsigned int texture;
+        std::uint32_t indexCount;
+    };
+
+    struct Stats
+    {
+        std::size_t resident;
+        std::size_t queued;
+        std::size_t loading;        // being read or waiting for upload
+        std::size_t residentBytes;
+        std::size_t pooledBytes;
+        unsigned long long uploads;
+        unsigned long long evictions;   // for the budget; leaving the unload radius is not counted
+        unsigned long long poolReuses;
+        unsigned long long poolAllocations;
+        std::size_t memoryBudget;       // as reclaim() and grant() left it
+        int textureReduction;           // halvings of the texture resolution of new loads
+        unsigned long long downscales;  // resident textures downscaled to the reduction
+    };
+
+public:
+    // writes a rolling heightfield of chunksX x chunksZ chunks, each a resolution x resolution grid of quads,
+    // textured with the image at texturePath shaded per chunk so the chunks stay visible
+    static void bake(const char * worldPath, const char * texturePath, int chunksX = 32, int chunksZ = 32,
+                     float chunkSize = 32.0f, int resolution = 64, int textureSize = 256)
+    {
+        cv::Mat source = cv::imread(texturePath, cv::IMREAD_COLOR);
+
+        if (source.empty())
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "cv::imread failed!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        cv::resize(source, source, cv::Size(textureSize, textureSize), 0, 0, cv::INTER_AREA);
+
+        std::ofstream fout {worldPath, std::ofstream::out | std::ofstream::binary};
+
+        if (!fout)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "World file not successfully opened for writing!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        WorldFileHeader header {};
+        std::memcpy(header.magic, "WSWF", 4);
+        header.version = 1;
+        header.chunksX = chunksX;
+        header.chunksZ = chunksZ;
+        header.chunkSize = chunkSize;
+
+        // the records are written again at the end, once the offsets are known
+        std::vector<ChunkRecord> records(static_cast<std::size_t>(chunksX) * chunksZ);
+        fout.write(reinterpret_cast<const char *>(&header), sizeof(WorldFileHeader));
+        fout.write(reinterpret_cast<const char *>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(ChunkRecord)));
+
+        std::uint64_t offset = sizeof(WorldFileHeader) + records.size() * sizeof(ChunkRecord);
+        float step = chunkSize / static_cast<float>(resolution);
+
+        for (int z = 0; z != chunksZ; ++z)
+        {
+            for (int x = 0; x != chunksX; ++x)
+            {
+                ChunkRecord & record = records[static_cast<std::size_t>(z) * chunksX + x];
+                record.minHeight = std::numeric_limits<float>::max();
+                record.maxHeight = std::numeric_limits<float>::lowest();
+
+                std::vector<MeshVertex> vertices;
+                vertices.reserve(static_cast<std::size_t>(resolution + 1) * (resolution + 1));
+
+                for (int j = 0; j <= resolution; ++j)
+                {
+                    for (int i = 0; i <= resolution; ++i)
+                    {
+                        // heights from world coordinates, so neighbouring chunks meet without seams
+                        float height = terrainHeight(x * chunkSize + i * step, z * chunkSize + j * step);
+                        record.minHeight = std::min(record.minHeight, height);
+                        record.maxHeight = std::max(record.maxHeight, height);
+
+                        vertices.push_back({glm::vec3(i * step, height, j * step),
+                                            glm::vec2(static_cast<float>(i) / resolution,
+                                                      static_cast<float>(j) / resolution)});
+                    }
+                }
+
+                // two triangles per quad, counter-clockwise seen from above
+                std::vector<unsigned int> indices;
+                indices.reserve(static_cast<std::size_t>(resolution) * resolution * 6);
+
+                for (int j = 0; j != resolution; ++j)
+                {
+                    for (int i = 0; i != resolution; ++i)
+                    {
+                        unsigned int a = j * (resolution + 1) + i;
+                        unsigned int c = a + resolution + 1;
+                        indices.insert(indices.end(), {a, c, a + 1, a + 1, c, c + 1});
+                    }
+                }
+
+                cv::Mat shaded;
+                source.convertTo(shaded, -1, 0.6 + 0.1 * ((x * 7 + z * 3) % 5));
+                std::vector<unsigned char> encoded;
+                cv::imencode(".jpg", shaded, encoded, {cv::IMWRITE_JPEG_QUALITY, 90});
+
+                record.offset = offset;
+                record.vertexCount = static_cast<std::uint32_t>(vertices.size());
+                record.indexCount = static_cast<std::uint32_t>(indices.size());
+                record.textureBytes = static_cast<std::uint32_t>(encoded.size());
+
+                fout.write(reinterpret_cast<const char *>(vertices.data()),
+                           static_cast<std::streamsize>(vertices.size() * sizeof(MeshVertex)));
+                fout.write(reinterpret_cast<const char *>(indices.data()),
+                           static_cast<std::streamsize>(indices.size() * sizeof(unsigned int)));
+                fout.write(reinterpret_cast<const char *>(encoded.data()),
+                           static_cast<std::streamsize>(encoded.size()));
+
+                offset += vertices.size() * sizeof(MeshVertex) + indices.size() * sizeof(unsigned int) +
+                          encoded.size();
+            }
+        }
+
+        fout.seekp(sizeof(WorldFileHeader));
+        fout.write(reinterpret_cast<const char *>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(ChunkRecord)));
+    }
+
+    explicit WorldStreamer(const char * worldPath, const WorldStreamerSettings & settings = WorldStreamerSettings()) :
+            worldPath(worldPath),
+            settings(settings)
+    {
+        std::ifstream fin {worldPath, std::ifstream::in | std::ifstream::binary};
+
+        if (!fin || !fin.read(reinterpret_cast<char *>(&header), sizeof(WorldFileHeader)) ||
+            std::memcmp(header.magic, "WSWF", 4) != 0)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "World file not successfully read!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        records.resize(static_cast<std::size_t>(header.chunksX) * header.chunksZ);
+
+        if (!fin.read(reinterpret_cast<char *>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(ChunkRecord))))
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "World file chunk records not successfully read!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        for (int i = 0; i != settings.ioThreads; ++i)
+        {
+            workers.emplace_back(&WorldStreamer::ioLoop, this);
+        }
+    }
+
+    WorldStreamer(const WorldStreamer &) = delete;
+
+    WorldStreamer & operator=(const WorldStreamer &) = delete;
+
+    ~WorldStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            stopping = true;
+        }
+
+        requestCondition.notify_all();
+
+        for (std::thread & worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // unloads the chunks out of range, queues those in range by priority and uploads at most uploadsPerFrame loaded
+    // chunks; call once per frame with the camera's position and unit front vector
+    void update(const glm::vec3 & position, const glm::vec3 & front)
+    {
+        cameraPosition = position;
+        cameraFront = front;
+
+        for (auto it = resident.begin(); it != resident.end();)
+        {
+            if (horizontalDistance(it->first) > settings.unloadRadius)
+            {
+                release(it->second);
+                it = resident.erase(it);
+
+                // memory was freed, so chunks the budget turned away may fit again
+                budgetLimit = std::numeric_limits<float>::max();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        queueChunksInRange();
+
+        std::vector<LoadedChunk> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(completedMutex);
+
+            while (!completed.empty() && static_cast<int>(ready.size()) < settings.uploadsPerFrame)
+            {
+                ready.emplace_back(std::move(completed.front()));
+                completed.pop_front();
+            }
+        }
+
+        for (LoadedChunk & loaded : ready)
+        {
+            {
+                std::lock_guard<std::mutex> lock(requestMutex);
+                inFlight.erase(loaded.coord);
+            }
+
+            // the camera may have moved on while it loaded
+            if (horizontalDistance(loaded.coord) > settings.unloadRadius)
+            {
+                continue;
+            }
+
+            float priority = chunkPriority(loaded.coord);
+            Chunk chunk {};
+
+            if (!makeRoom(loaded, priority, chunk))
+            {
+                budgetLimit = std::min(budgetLimit, priority);
+                continue;
+            }
+
+            upload(loaded, chunk);
+        }
+
+        downscaleResident();
+    }
+
+    // gives back GPU memory: the pooled resources first, then texture resolution -- new loads are decoded smaller and
+    // resident textures are downscaled over the next frames, farthest first -- and last the resident chunks of worst
+    // priority. The budget is lowered to what remains, so the memory is not streamed right back in. Returns the bytes
+    // freed now and those the pending downscales will free.
+    std::size_t reclaim(std::size_t bytes)
+    {
+        std::size_t freed = getPooledBytes();
+        bufferPool.trim(0);
+        texturePool.trim(0);
+
+        std::size_t pending = pendingDownscaleBytes();
+
+        if (freed + pending < bytes && textureReduction < settings.maxTextureReduction)
+        {
+            ++textureReduction;
+            pending = pendingDownscaleBytes();
+        }
+
+        while (freed + pending < bytes && !resident.empty())
+        {
+            auto victim = std::max_element(resident.begin(), resident.end(), [this](const auto & lhs, const auto & rhs)
+            {
+                return chunkPriority(lhs.first) < chunkPriority(rhs.first);
+            });
+
+            std::size_t chunkBytes = victim->second.getBytes();
+            freed += chunkBytes;
+            pending -= downscaleSavings(victim->second);
+            residentBytes -= chunkBytes;
+            budgetLimit = std::min(budgetLimit, chunkPriority(victim->first));
+            resident.erase(victim);
+            ++evictions;
+        }
+
+        memoryBudget = std::min(memoryBudget, residentBytes - pending);
+
+        return freed + pending;
+    }
+
+    // lets the budget grow back by up to bytes, no further than settings.memoryBudget; once it is all back, new loads
+    // are decoded a reduction sharper (resident chunks keep their resolution until they are reloaded)
+    void grant(std::size_t bytes)
+    {
+        if (memoryBudget < settings.memoryBudget)
+        {
+            memoryBudget = std::min(settings.memoryBudget, memoryBudget + bytes);
+
+            // chunks the budget turned away may fit again
+            budgetLimit = std::numeric_limits<float>::max();
+        }
+        else if (textureReduction > 0 && pendingDownscaleBytes() == 0)
+        {
+            --textureReduction;
+        }
+    }
+
+    // calls function(const ResidentChunk &) for every resident chunk
+    template <typename Function>
+    void forEachResident(const Function & function) const
+    {
+        for (const auto & entry : resident)
+        {
+            function(entry.second.drawable);
+        }
+    }
+
+    const WorldFileHeader & getHeader() const
+    {
+        return header;
+    }
+
+    // the centre of the world at height 0
+    glm::vec3 getCenter() const
+    {
+        return glm::vec3(header.chunksX * header.chunkSize * 0.5f, 0.0f, header.chunksZ * header.chunkSize * 0.5f);
+    }
+
+    Stats getStats()
+    {
+        Stats stats {};
+        stats.resident = resident.size();
+        stats.residentBytes = residentBytes;
+        stats.pooledBytes = getPooledBytes();
+        stats.uploads = uploads;
+        stats.evictions = evictions;
+        stats.poolReuses = bufferPool.getStats().hits + texturePool.getStats().hits + vertexArrayReuses;
+        stats.poolAllocations = bufferPool.getStats().misses + texturePool.getStats().misses + vertexArrayAllocations;
+        stats.memoryBudget = memoryBudget;
+        stats.textureReduction = textureReduction;
+        stats.downscales = downscales;
+
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stats.queued = queued.size();
+        stats.loading = inFlight.size();
+
+        return stats;
+    }
+
+private:
+    struct LoadedChunk
+    {
+        ChunkCoord coord;
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+        cv::Mat texture;
+        int reduction;              // the texture was decoded at
+    };
+
+    struct Chunk
+    {
+        ResidentChunk drawable;
+        GlVertexArray vertexArray;
+        GlBuffer vertexBuffer;
+        GlBuffer indexBuffer;
+        GlTexture texture;
+        int reduction;              // of the texture
+
+        std::size_t getBytes() const
+        {
+            return vertexBuffer.getCapacity() + indexBuffer.getCapacity() + texture.getBytes();
+        }
+    };
+
+    static float terrainHeight(float x, float z)
+    {
+        return 6.0f * std::sin(x * 0.021f) * std::cos(z * 0.017f) +
+               2.5f * std::sin(x * 0.063f + z * 0.049f) +
+               0.8f * std::sin(x * 0.19f - z * 0.23f);
+    }
+
+    // what GlTexture::getBytes counts for a chunk texture: GL_RGB8 with the mip chain
+    static std::size_t textureBytes(int width, int height)
+    {
+        std::size_t bytes = 0;
+
+        for (int level = 0; level != GlTexture::getLevelCount(width, height); ++level)
+        {
+            bytes += static_cast<std::size_t>(std::max(1, width >> level)) * std::max(1, height >> level) *
+                     getTexelBytes(GL_RGB8);
+        }
+
+        return bytes;
+    }
+
+    const ChunkRecord & record(const ChunkCoord & coord) const
+    {
+        return records[static_cast<std::size_t>(coord.z) * header.chunksX + coord.x];
+    }
+
+    glm::vec3 chunkOrigin(const ChunkCoord & coord) const
+    {
+        return glm::vec3(coord.x * header.chunkSize, 0.0f, coord.z * header.chunkSize);
+    }
+
+    glm::vec3 chunkCenter(const ChunkCoord & coord) const
+    {
+        const ChunkRecord & chunk = record(coord);
+        return chunkOrigin(coord) +
+               glm::vec3(header.chunkSize * 0.5f, (chunk.minHeight + chunk.maxHeight) * 0.5f, header.chunkSize * 0.5f);
+    }
+
+    // the radii are measured on the ground plane, so flying higher does not unload the terrain below
+    float horizontalDistance(const ChunkCoord & coord) const
+    {
+        glm::vec3 offset = chunkCenter(coord) - cameraPosition;
+        return std::sqrt(offset.x * offset.x + offset.z * offset.z);
+    }
+
+    // lower loads first: the distance, stretched for chunks away from the view direction
+    float chunkPriority(const ChunkCoord & coord) const
+    {
+        glm::vec3 offset = chunkCenter(coord) - cameraPosition;
+        float distance = glm::length(offset);
+        float facing = distance > 0.0f ? glm::dot(offset / distance, cameraFront) : 1.0f;
+
+        return distance * (1.0f + settings.viewWeight * 0.5f * (1.0f - facing));
+    }
+
+    // replaces the queue with the chunks in range that are neither resident nor loading
+    void queueChunksInRange()
+    {
+        float reach = settings.loadRadius + header.chunkSize;
+        int minX = std::max(0, static_cast<int>(std::floor((cameraPosition.x - reach) / header.chunkSize)));
+        int maxX = std::min(static_cast<int>(header.chunksX) - 1,
+                            static_cast<int>(std::floor((cameraPosition.x + reach) / header.chunkSize)));
+        int minZ = std::max(0, static_cast<int>(std::floor((cameraPosition.z - reach) / header.chunkSize)));
+        int maxZ = std::min(static_cast<int>(header.chunksZ) - 1,
+                            static_cast<int>(std::floor((cameraPosition.z + reach) / header.chunkSize)));
+
+        std::vector<std::pair<ChunkCoord, float>> wanted;
+
+        for (int z = minZ; z <= maxZ; ++z)
+        {
+            for (int x = minX; x <= maxX; ++x)
+            {
+                ChunkCoord coord {x, z};
+
+                if (resident.count(coord) || horizontalDistance(coord) > settings.loadRadius)
+                {
+                    continue;
+                }
+
+                float priority = chunkPriority(coord);
+
+                if (priority < budgetLimit)
+                {
+                    wanted.emplace_back(coord, priority);
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            queued.clear();
+
+            for (const auto & chunk : wanted)
+            {
+                if (!inFlight.count(chunk.first))
+                {
+                    queued.insert(chunk);
+                }
+            }
+        }
+
+        requestCondition.notify_all();
+    }
+
+    // takes what loaded can reuse from the pools into chunk, then brings the budget down until the rest fits: other
+    // pooled resources go first, oldest first, then resident chunks of lower priority than its own; false if it still
+    // does not fit, in which case chunk's resources are back in the pools
+    bool makeRoom(const LoadedChunk & loaded, float priority, Chunk & chunk)
+    {
+        std::size_t vertexBytes = loaded.vertices.size() * sizeof(MeshVertex);
+        std::size_t indexBytes = loaded.indices.size() * sizeof(unsigned int);
+        int width = loaded.texture.cols;
+        int height = loaded.texture.rows;
+
+        while (true)
+        {
+            // what an eviction returned to the pools may match now
+            if (!chunk.vertexBuffer)
+            {
+                chunk.vertexBuffer = bufferPool.tryAcquire(vertexBytes, GL_STATIC_DRAW);
+            }
+
+            if (!chunk.indexBuffer)
+            {
+                chunk.indexBuffer = bufferPool.tryAcquire(indexBytes, GL_STATIC_DRAW);
+            }
+
+            if (!chunk.texture)
+            {
+                chunk.texture = texturePool.tryAcquire(GL_RGB8, width, height, GlTexture::getLevelCount(width, height));
+            }
+
+            std::size_t needed = chunk.getBytes();
+
+            if (!chunk.vertexBuffer)
+            {
+                needed += GlBufferPool::getSizeClass(vertexBytes);
+            }
+
+            if (!chunk.indexBuffer)
+            {
+                needed += GlBufferPool::getSizeClass(indexBytes);
+            }
+
+            if (!chunk.texture)
+            {
+                needed += textureBytes(width, height);
+            }
+
+            std::size_t pooledBytes = getPooledBytes();
+
+            if (residentBytes + pooledBytes + needed <= memoryBudget)
+            {
+                return true;
+            }
+
+            if (pooledBytes != 0)
+            {
+                trimPools(residentBytes + pooledBytes + needed - memoryBudget);
+                continue;
+            }
+
+            auto victim = resident.end();
+            float victimPriority = priority;
+
+            for (auto it = resident.begin(); it != resident.end(); ++it)
+            {
+                float residentPriority = chunkPriority(it->first);
+
+                if (residentPriority > victimPriority)
+                {
+                    victim = it;
+                    victimPriority = residentPriority;
+                }
+            }
+
+            if (victim == resident.end())
+            {
+                bufferPool.release(std::move(chunk.vertexBuffer));
+                bufferPool.release(std::move(chunk.indexBuffer));
+                texturePool.release(std::move(chunk.texture));
+                return false;
+            }
+
+            // its resources go to the pools, where the next iteration may find them a match
+            release(victim->second);
+            resident.erase(victim);
+            ++evictions;
+            budgetLimit = std::min(budgetLimit, victimPriority);
+        }
+    }
+
+    std::size_t getPooledBytes() const
+    {
+        return bufferPool.getStats().pooledBytes + texturePool.getStats().pooledBytes;
+    }
+
+    // deletes pooled resources, buffers before textures and each oldest first, until at least bytes are freed or
+    // the pools are empty
+    void trimPools(std::size_t bytes)
+    {
+        std::size_t buffers = bufferPool.getStats().pooledBytes;
+        bufferPool.trim(buffers > bytes ? buffers - bytes : 0);
+        bytes -= std::min(bytes, buffers - bufferPool.getStats().pooledBytes);
+
+        std::size_t textures = texturePool.getStats().pooledBytes;
+        texturePool.trim(textures > bytes ? textures - bytes : 0);
+    }
+
+    GlTexture acquireTexture(int width, int height)
+    {
+        GlTexture texture = texturePool.acquire(GL_RGB8, width, height, GlTexture::getLevelCount(width, height), GL_BGR,
+                                                GL_UNSIGNED_BYTE);
+
+        // a pooled texture keeps these from its last chunk, a new one needs them
+        glBindTexture(GL_TEXTURE_2D, texture.get());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        return texture;
+    }
+
+    // fills chunk with loaded, allocating whatever makeRoom found no pooled match for
+    void upload(const LoadedChunk & loaded, Chunk & chunk)
+    {
+        std::size_t vertexBytes = loaded.vertices.size() * sizeof(MeshVertex);
+        std::size_t indexBytes = loaded.indices.size() * sizeof(unsigned int);
+
+        if (!chunk.vertexBuffer)
+        {
+            chunk.vertexBuffer = bufferPool.acquire(vertexBytes, GL_STATIC_DRAW);
+        }
+
+        if (!chunk.indexBuffer)
+        {
+            chunk.indexBuffer = bufferPool.acquire(indexBytes, GL_STATIC_DRAW);
+        }
+
+        if (chunk.texture)
+        {
+            glBindTexture(GL_TEXTURE_2D, chunk.texture.get());
+        }
+        else
+        {
+            chunk.texture = acquireTexture(loaded.texture.cols, loaded.texture.rows);
+        }
+
+        if (!freeVertexArrays.empty())
+        {
+            chunk.vertexArray = std::move(freeVertexArrays.back());
+            freeVertexArrays.pop_back();
+            ++vertexArrayReuses;
+        }
+        else
+        {
+            chunk.vertexArray = GlVertexArray(GlCategory::Geometry, "chunk vertex array");
+            ++vertexArrayAllocations;
+        }
+
+        chunk.reduction = loaded.reduction;
+
+        // the buffers may differ from the vertex array's last ones, so the attributes are set again; the element
+        // array binding belongs to the vertex array
+        glBindVertexArray(chunk.vertexArray.get());
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.vertexBuffer.get());
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(vertexBytes), loaded.vertices.data());
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.indexBuffer.get());
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(indexBytes), loaded.indices.data());
+
+        // position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                              reinterpret_cast<void *>(offsetof(MeshVertex, position)));
+        glEnableVertexAttribArray(0);
+
+        // texture coord attribute
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex),
+                              reinterpret_cast<void *>(offsetof(MeshVertex, texCoord)));
+        glEnableVertexAttribArray(1);
+
+        glBindVertexArray(0);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, loaded.texture.cols, loaded.texture.rows, GL_BGR, GL_UNSIGNED_BYTE,
+                        loaded.texture.data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        const ChunkRecord & chunkRecord = record(loaded.coord);
+        float halfHeight = (chunkRecord.maxHeight - chunkRecord.minHeight) * 0.5f;
+
+        chunk.drawable.coord = loaded.coord;
+        chunk.drawable.origin = chunkOrigin(loaded.coord);
+        chunk.drawable.center = chunkCenter(loaded.coord);
+        chunk.drawable.radius = glm::length(glm::vec3(header.chunkSize * 0.5f, halfHeight, header.chunkSize * 0.5f));
+        chunk.drawable.vertexArray = chunk.vertexArray.get();
+        chunk.drawable.texture = chunk.texture.get();
+        chunk.drawable.indexCount = static_cast<std::uint32_t>(loaded.indices.size());
+
+        residentBytes += chunk.getBytes();
+        resident.emplace(loaded.coord, std::move(chunk));
+        ++uploads;
+    }
+
+    // moves the chunk's resources to the pools; the caller erases it from resident
+    void release(Chunk & chunk)
+    {
+        residentBytes -= chunk.getBytes();
+
+        bufferPool.release(std::move(chunk.vertexBuffer));
+        bufferPool.release(std::move(chunk.indexBuffer));
+        texturePool.release(std::move(chunk.texture));
+        freeVertexArrays.push_back(std::move(chunk.vertexArray));
+    }
+
+    // what downscaling the chunk's texture to the current reduction frees
+    std::size_t downscaleSavings(const Chunk & chunk) const
+    {
+        int halvings = textureReduction - chunk.reduction;
+
+        if (halvings <= 0)
+        {
+            return 0;
+        }
+
+        return chunk.texture.getBytes() - textureBytes(std::max(1, chunk.texture.getWidth() >> halvings),
+                                                       std::max(1, chunk.texture.getHeight() >> halvings));
+    }
+
+    std::size_t pendingDownscaleBytes() const
+    {
+        std::size_t bytes = 0;
+
+        for (const auto & entry : resident)
+        {
+            bytes += downscaleSavings(entry.second);
+        }
+
+        return bytes;
+    }
+
+    // downscales up to uploadsPerFrame resident textures to the current reduction, farthest first; a chunk whose
+    // texture cannot be downscaled is evicted instead
+    void downscaleResident()
+    {
+        for (int i = 0; i != settings.uploadsPerFrame; ++i)
+        {
+            auto farthest = resident.end();
+            float farthestPriority = std::numeric_limits<float>::lowest();
+
+            for (auto it = resident.begin(); it != resident.end(); ++it)
+            {
+                float priority = chunkPriority(it->first);
+
+                if (it->second.reduction < textureReduction && priority > farthestPriority)
+                {
+                    farthest = it;
+                    farthestPriority = priority;
+                }
+            }
+
+            if (farthest == resident.end())
+            {
+                return;
+            }
+
+            if (!downscale(farthest->second))
+            {
+                residentBytes -= farthest->second.getBytes();
+                resident.erase(farthest);
+                ++evictions;
+            }
+        }
+    }
+
+    // replaces the chunk's texture by a copy of the mip level of the current reduction, made on the GPU through a
+    // framebuffer with that level attached; false if the level cannot be attached
+    bool downscale(Chunk & chunk)
+    {
+        int level = std::min(textureReduction - chunk.reduction, chunk.texture.getLevels() - 1);
+        int width = std::max(1, chunk.texture.getWidth() >> level);
+        int height = std::max(1, chunk.texture.getHeight() >> level);
+
+        if (!downscaleFramebuffer)
+        {
+            downscaleFramebuffer = GlFramebuffer(GlCategory::Other, "chunk downscale");
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, downscaleFramebuffer.get());
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, chunk.texture.get(), level);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+        GlTexture texture;
+
+        if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+        {
+            texture = acquireTexture(width, height);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+        if (!texture)
+        {
+            return false;
+        }
+
+        // the full-size texture is deleted rather than pooled: its memory is what was asked for
+        residentBytes = residentBytes - chunk.texture.getBytes() + texture.getBytes();
+        chunk.texture = std::move(texture);
+        chunk.drawable.texture = chunk.texture.get();
+        chunk.reduction = textureReduction;
+        ++downscales;
+
+        return true;
+    }
+
+    // background I/O: reads and decodes the queued chunk of best priority
+    void ioLoop()
+    {
+        std::ifstream fin {worldPath, std::ifstream::in | std::ifstream::binary};
+
+        while (true)
+        {
+            ChunkCoord coord {};
+
+            {
+                std::unique_lock<std::mutex> lock(requestMutex);
+                requestCondition.wait(lock, [this] { return stopping || !queued.empty(); });
+
+                if (stopping)
+                {
+                    return;
+                }
+
+                auto best = std::min_element(queued.begin(), queued.end(), [](const auto & lhs, const auto & rhs)
+                {
+                    return lhs.second < rhs.second;
+                });
+
+                coord = best->first;
+                queued.erase(best);
+                inFlight.insert(coord);
+            }
+
+            const ChunkRecord & chunkRecord = record(coord);
+            LoadedChunk loaded {coord, std::vector<MeshVertex>(chunkRecord.vertexCount),
+                                std::vector<unsigned int>(chunkRecord.indexCount), cv::Mat(), textureReduction};
+            std::vector<unsigned char> encoded(chunkRecord.textureBytes);
+
+            fin.seekg(static_cast<std::streamoff>(chunkRecord.offset));
+            fin.read(reinterpret_cast<char *>(loaded.vertices.data()),
+                     static_cast<std::streamsize>(loaded.vertices.size() * sizeof(MeshVertex)));
+            fin.read(reinterpret_cast<char *>(loaded.indices.data()),
+                     static_cast<std::streamsize>(loaded.indices.size() * sizeof(unsigned int)));
+            fin.read(reinterpret_cast<char *>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+
+            if (fin)
+            {
+                loaded.texture = cv::imdecode(encoded, cv::IMREAD_COLOR);
+            }
+
+            if (!loaded.texture.empty() && loaded.reduction > 0)
+            {
+                cv::Size size(std::max(1, loaded.texture.cols >> loaded.reduction),
+                              std::max(1, loaded.texture.rows >> loaded.reduction));
+                cv::resize(loaded.texture, loaded.texture, size, 0, 0, cv::INTER_AREA);
+            }
+
+            if (!fin || loaded.texture.empty())
+            {
+                fin.clear();
+                std::lock_guard<std::mutex> lock(requestMutex);
+                inFlight.erase(coord);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(completedMutex);
+            completed.push_back(std::move(loaded));
+        }
+    }
+
+private:
+    std::string worldPath;
+    WorldStreamerSettings settings;
+    WorldFileHeader header {};
+    std::vector<ChunkRecord> records;
+
+    // render thread only
+    glm::vec3 cameraPosition {0.0f};
+    glm::vec3 cameraFront {0.0f, 0.0f, -1.0f};
+    std::unordered_map<ChunkCoord, Chunk, ChunkCoordHash> resident;
+    // the pools may hold the whole budget; makeRoom() trims them when uploads need the memory
+    GlBufferPool bufferPool {GlCategory::Geometry, settings.memoryBudget, "chunk buffer"};
+    GlTexturePool texturePool {GlCategory::Texture, settings.memoryBudget, "chunk texture"};
+    std::vector<GlVertexArray> freeVertexArrays;
+    GlFramebuffer downscaleFramebuffer;
+    std::size_t residentBytes {0};
+    std::size_t memoryBudget {settings.memoryBudget};
+    float budgetLimit {std::numeric_limits<float>::max()};
+
+    unsigned long long uploads {0};
+    unsigned long long evictions {0};
+    unsigned long long vertexArrayReuses {0};
+    unsigned long long vertexArrayAllocations {0};
+    unsigned long long downscales {0};
+
+    // I/O
+    std::vector<std::thread> workers;
+    std::mutex requestMutex;
+    std::condition_variable requestCondition;
+    std::unordered_map<ChunkCoord, float, ChunkCoordHash> queued;
+    std::unordered_set<ChunkCoord, ChunkCoordHash> inFlight;
+    bool stopping {false};
+    std::atomic<int> textureReduction {0};      // set by the render thread, read by the workers
+
+    std::mutex completedMutex;
+    std::list<LoadedChunk> completed;
+};
+
+#endif // LEARNOPENGL_WORLD_STREAMER_H
@@ -0,0 +1,105 @@
+// 01_transform_bench: stress test of the job system on per-frame transform updates.
+//
+// usage: 01_transform_bench [transforms = 1000000] [iterations = 20]
+//
+// Builds one model matrix per transform (translate * rotate * scale, as the samples do per cube), serially and then
+// with parallelFor on job systems of increasing size, and prints the median time of each.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include "learnopengl/job_system.h"
+
+
+struct Transform
+{
+    glm::vec3 position;
+    glm::vec3 axis;
+    float angle;
+    float scale;
+};
+
+
+void updateTransforms(const std::vector<Transform> & transforms, std::vector<glm::mat4> & models,
+                      std::size_t first, std::size_t last, float time)
+{
+    for (std::size_t i = first; i != last; ++i)
+    {
+        const Transform & t = transforms[i];
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), t.position);
+        model = glm::rotate(model, t.angle + time, t.axis);
+        models[i] = glm::scale(model, glm::vec3(t.scale));
+    }
+}
+
+
+template <typename Function>
+double medianMilliseconds(int iterations, const Function & function)
+{
+    std::vector<double> times;
+
+    for (int i = 0; i != iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function(static_cast<float>(i));
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+
+    return times[times.size() / 2];
+}
+
+
+int main(int argc, char * argv[])
+{
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<Transform> transforms(count);
+    std::vector<glm::mat4> models(count);
+
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        transforms[i].position = glm::vec3(i % 100, (i / 100) % 100, i / 10000);
+        transforms[i].axis = glm::normalize(glm::vec3(1.0f, 0.3f + 0.001f * (i % 7), 0.5f));
+        transforms[i].angle = 0.01f * static_cast<float>(i % 360);
+        transforms[i].scale = 0.5f + 0.001f * static_cast<float>(i % 500);
+    }
+
+    double serial = medianMilliseconds(iterations, [&](float time)
+    {
+        updateTransforms(transforms, models, 0, count, time);
+    });
+
+    std::cout << std::fixed << std::setprecision(3)
+              << count << " transforms, median of " << iterations << " iterations\n"
+              << "serial:      " << serial << " ms\n";
+
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int threads = 1; threads <= hardwareThreads; threads *= 2)
+    {
+        JobSystem jobSystem(threads - 1);
+
+        double parallel = medianMilliseconds(iterations, [&](float time)
+        {
+            jobSystem.parallelFor(0, count, 4096, [&](std::size_t first, std::size_t last)
+            {
+                updateTransforms(transforms, models, first, last, time);
+            });
+        });
+
+        std::cout << std::setw(2) << threads << " threads:  " << parallel << " ms (x" << serial / parallel << ")\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,390 @@
+// 02_soft_raster_bench: the software rasterizer on the cube grid of 12_render_thread.
+//
+// usage: 02_soft_raster_bench [cubes per side = 10] [iterations = 20] [output.ppm]
+//        02_soft_raster_bench --scene09 <output.png> [golden.png [--missing-golden skip|fail]]
+//
+// Renders the scene at 800x600 on job systems of increasing size and prints the median frame time of each, with a
+// hash of the image: the hashes must all be equal, since the result does not depend on the thread count.
+// The textures are generated, so the benchmark needs no image files; the last frame is optionally written as PPM.
+//
+// --scene09 renders the ten cubes of 09_coordinate_systems with its textures instead, writes the image as PNG and,
+// given a golden image captured from the GL sample (09_coordinate_systems --capture golden.png), compares the two
+// with ImageCompare: the exit code is 0 if they match and 1 if not, or if the golden image does not exist; with
+// --missing-golden skip, a missing golden image exits with HeadlessCapture::kSkipExitCode (77) instead. A failed
+// comparison writes <output>.diff.png next to the output. Run it from the repository root, where etc/ holds the
+// textures.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "learnopengl/image_compare.h"
+#include "learnopengl/job_system.h"
+#include "learnopengl/soft_rasterizer.h"
+
+
+const int SCR_WIDTH = 800;
+const int SCR_HEIGHT = 600;
+
+// the exit code of --scene09 --missing-golden skip without a golden image, as HeadlessCapture::kSkipExitCode
+const int SKIP_EXIT_CODE = 77;
+
+// the cube of samples 09 to 12: 36 vertices of aPos and aTexCoord
+const float vertices[] = {
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+
+// RGB bytes of a checkerboard in two colors
+std::vector<unsigned char> checkerboard(int size, int cells, const glm::vec3 & a, const glm::vec3 & b)
+{
+    std::vector<unsigned char> texels(static_cast<std::size_t>(size) * size * 3);
+
+    for (int y = 0; y != size; ++y)
+    {
+        for (int x = 0; x != size; ++x)
+        {
+            const glm::vec3 & c = ((x * cells / size) + (y * cells / size)) % 2 ? a : b;
+            unsigned char * texel = &texels[(static_cast<std::size_t>(y) * size + x) * 3];
+            texel[0] = static_cast<unsigned char>(c.x * 255.0f);
+            texel[1] = static_cast<unsigned char>(c.y * 255.0f);
+            texel[2] = static_cast<unsigned char>(c.z * 255.0f);
+        }
+    }
+
+    return texels;
+}
+
+
+// FNV-1a over the color buffer
+std::uint64_t hashImage(const SoftFramebuffer & framebuffer)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    std::size_t count = static_cast<std::size_t>(framebuffer.getWidth()) * framebuffer.getHeight();
+
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        hash = (hash ^ framebuffer.getColor()[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+
+void writePpm(const char * path, const SoftFramebuffer & framebuffer)
+{
+    std::ofstream fout {path, std::ofstream::out | std::ofstream::binary};
+    fout << "P6\n" << framebuffer.getWidth() << ' ' << framebuffer.getHeight() << "\n255\n";
+
+    // PPM rows run top to bottom
+    for (int y = framebuffer.getHeight() - 1; y >= 0; --y)
+    {
+        for (int x = 0; x != framebuffer.getWidth(); ++x)
+        {
+            std::uint32_t c = framebuffer.getColor()[static_cast<std::size_t>(y) * framebuffer.getWidth() + x];
+            char rgb[3] = {static_cast<char>(c & 0xFF), static_cast<char>(c >> 8 & 0xFF),
+                           static_cast<char>(c >> 16 & 0xFF)};
+            fout.write(rgb, 3);
+        }
+    }
+}
+
+
+// as HeadlessCapture reads back the GL frame: BGR, top row first
+cv::Mat toImage(const SoftFramebuffer & framebuffer)
+{
+    cv::Mat image(framebuffer.getHeight(), framebuffer.getWidth(), CV_8UC3);
+
+    for (int y = 0; y != framebuffer.getHeight(); ++y)
+    {
+        const std::uint32_t * row = framebuffer.getColor() + static_cast<std::size_t>(y) * framebuffer.getWidth();
+        unsigned char * bgr = image.ptr(framebuffer.getHeight() - 1 - y);
+
+        for (int x = 0; x != framebuffer.getWidth(); ++x)
+        {
+            bgr[3 * x] = static_cast<unsigned char>(row[x] >> 16 & 0xFF);
+            bgr[3 * x + 1] = static_cast<unsigned char>(row[x] >> 8 & 0xFF);
+            bgr[3 * x + 2] = static_cast<unsigned char>(row[x] & 0xFF);
+        }
+    }
+
+    return image;
+}
+
+
+cv::Mat readImage(const char * path)
+{
+    cv::Mat image = cv::imread(path);
+
+    if (image.empty())
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "cv::imread failed for " << path << '!'
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    return image;
+}
+
+
+// the frame of 09_coordinate_systems, written to outputPath and compared with goldenPath if given
+int renderScene09(const char * outputPath, const char * goldenPath, bool skipMissingGolden)
+{
+    // uploaded as 09 does: the BGR rows of cv::imread passed on as GL_RGB
+    cv::Mat brick = readImage("etc/brick.jpg");
+    cv::Mat tree = readImage("etc/tree.jpg");
+    SoftTexture texture1(brick.data, brick.cols, brick.rows, 3, brick.step);
+    SoftTexture texture2(tree.data, tree.cols, tree.rows, 3, tree.step);
+
+    const glm::vec3 cubePositions[] = {
+            glm::vec3( 0.0f,  0.0f,  0.0f),
+            glm::vec3( 2.0f,  5.0f, -15.0f),
+            glm::vec3(-1.5f, -2.2f, -2.5f),
+            glm::vec3(-3.8f, -2.0f, -12.3f),
+            glm::vec3( 2.4f, -0.4f, -3.5f),
+            glm::vec3(-1.7f,  3.0f, -7.5f),
+            glm::vec3( 1.3f, -2.0f, -2.5f),
+            glm::vec3( 1.5f,  2.0f, -2.5f),
+            glm::vec3( 1.5f,  0.2f, -1.5f),
+            glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    SoftProgram program;
+    program.projection = glm::perspective(glm::radians(45.0f), static_cast<float>(SCR_WIDTH) / SCR_HEIGHT,
+                                          0.1f, 100.0f);
+    program.view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+    program.texture1 = &texture1;
+    program.texture2 = &texture2;
+
+    JobSystem jobSystem;
+    SoftRasterizer rasterizer(jobSystem);
+    SoftFramebuffer framebuffer(SCR_WIDTH, SCR_HEIGHT);
+
+    framebuffer.clear(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+    rasterizer.begin(framebuffer);
+    rasterizer.setDepthTest(true);
+
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        float angle = 20.0f * static_cast<float>(i);
+        program.model = glm::rotate(glm::translate(glm::mat4(1.0f), cubePositions[i]), glm::radians(angle),
+                                    glm::vec3(1.0f, 0.3f, 0.5f));
+        rasterizer.draw(program, vertices, nullptr, 0, 36);
+    }
+
+    rasterizer.finish();
+
+    cv::Mat image = toImage(framebuffer);
+
+    if (!cv::imwrite(outputPath, image))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "cv::imwrite failed for " << outputPath << '!'
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    if (!goldenPath)
+    {
+        return 0;
+    }
+
+    cv::Mat golden = cv::imread(goldenPath);
+
+    if (golden.empty())
+    {
+        std::cout << (skipMissingGolden ? "[SKIP] " : "[FAIL] ") << goldenPath << ": golden image missing, "
+                  << "capture it with 09_coordinate_systems --capture " << goldenPath << std::endl;
+        return skipMissingGolden ? SKIP_EXIT_CODE : 1;
+    }
+
+    // looser than between GL drivers: mip level selection and filtering only approximate those of a GPU
+    ImageTolerance tolerance;
+    tolerance.channelTolerance = 16;
+    tolerance.maxMismatchRatio = 0.01;
+    tolerance.minSsim = 0.95;
+
+    ImageComparison result = ImageCompare::compare(image, golden, tolerance);
+
+    if (!result.sizeMatches)
+    {
+        std::cout << "[FAIL] " << goldenPath << ": rendered " << image.cols << 'x' << image.rows
+                  << ", golden " << golden.cols << 'x' << golden.rows << std::endl;
+        return 1;
+    }
+
+    std::cout << (result.passed ? "[PASS] " : "[FAIL] ") << goldenPath
+              << ": max difference " << result.maxDifference
+              << ", mean " << result.meanDifference
+              << ", mismatching pixels " << result.mismatchRatio * 100.0 << "%"
+              << ", SSIM " << result.ssim << std::endl;
+
+    if (!result.passed)
+    {
+        std::string path = outputPath;
+        cv::imwrite(path.substr(0, path.rfind('.')) + ".diff.png", result.difference * 8);
+    }
+
+    return result.passed ? 0 : 1;
+}
+
+
+int main(int argc, char * argv[])
+{
+    if (argc > 2 && !std::strcmp(argv[1], "--scene09"))
+    {
+        bool skipMissingGolden = argc > 5 && !std::strcmp(argv[4], "--missing-golden") &&
+                                 !std::strcmp(argv[5], "skip");
+        return renderScene09(argv[2], argc > 3 ? argv[3] : nullptr, skipMissingGolden);
+    }
+
+    int cubesPerSide = argc > 1 ? std::atoi(argv[1]) : 10;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+    const char * outputPath = argc > 3 ? argv[3] : nullptr;
+
+    if (iterations <= 0)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "iterations must be positive!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    std::vector<unsigned char> image1 = checkerboard(512, 8, glm::vec3(0.7f, 0.3f, 0.2f), glm::vec3(0.9f, 0.8f, 0.7f));
+    std::vector<unsigned char> image2 = checkerboard(256, 2, glm::vec3(0.1f, 0.5f, 0.1f), glm::vec3(0.2f, 0.2f, 0.6f));
+    SoftTexture texture1(image1.data(), 512, 512, 3);
+    SoftTexture texture2(image2.data(), 256, 256, 3);
+
+    // the camera and grid of 12_render_thread, with each cube at a fixed angle
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), static_cast<float>(SCR_WIDTH) / SCR_HEIGHT,
+                                            0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    std::vector<glm::mat4> models;
+
+    for (int x = 0; x != cubesPerSide; ++x)
+    {
+        for (int y = 0; y != cubesPerSide; ++y)
+        {
+            for (int z = 0; z != cubesPerSide; ++z)
+            {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f * x - cubesPerSide,
+                                                                            2.0f * y - cubesPerSide,
+                                                                            -2.0f * z - 5.0f));
+                float angle = 20.0f * static_cast<float>(models.size() % 18);
+                models.push_back(glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f)));
+            }
+        }
+    }
+
+    SoftFramebuffer framebuffer(SCR_WIDTH, SCR_HEIGHT);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << models.size() << " cubes at " << SCR_WIDTH << 'x' << SCR_HEIGHT << ", median of " << iterations
+              << " iterations\n";
+
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int threads = 1; threads <= hardwareThreads; threads *= 2)
+    {
+        JobSystem jobSystem(threads - 1);
+        SoftRasterizer rasterizer(jobSystem);
+        std::vector<double> times;
+
+        for (int i = 0; i != iterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+
+            framebuffer.clear(glm::vec4(0.2f, 0.3f, 0.3f, 1.0f));
+            rasterizer.begin(framebuffer);
+            rasterizer.setDepthTest(true);
+
+            SoftProgram program;
+            program.projection = projection;
+            program.view = view;
+            program.texture1 = &texture1;
+            program.texture2 = &texture2;
+
+            for (const glm::mat4 & model : models)
+            {
+                program.model = model;
+                rasterizer.draw(program, vertices, nullptr, 0, 36);
+            }
+
+            rasterizer.finish();
+
+            auto time = std::chrono::steady_clock::now() - start;
+            times.push_back(std::chrono::duration<double, std::milli>(time).count());
+        }
+
+        std::sort(times.begin(), times.end());
+
+        std::cout << std::setw(2) << threads << " threads:  " << times[times.size() / 2] << " ms, image "
+                  << std::hex << hashImage(framebuffer) << std::dec << '\n';
+    }
+
+    if (outputPath)
+    {
+        writePpm(outputPath, framebuffer);
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// 03_camera_set_bench: view, projection and frustum derivation for many cameras.
+//
+// usage: 03_camera_set_bench [cameras = 4096] [iterations = 200]
+//
+// Computes every camera's view (glm::lookAt), view-projection and Frustum one camera at a time with glm, then with
+// CameraSet::update(), and prints the median time of each and the largest difference between their results. Half the
+// cameras are perspective views, the other half orthographic shadow cascades.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+#include "learnopengl/camera.h"
+
+
+struct CameraDescription
+{
+    glm::vec3 position;
+    glm::quat orientation;
+    bool orthographic;
+};
+
+
+template <typename Function>
+double medianMilliseconds(int iterations, const Function & function)
+{
+    std::vector<double> times;
+
+    for (int i = 0; i != iterations; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+
+    return times[times.size() / 2];
+}
+
+
+float maxDifference(const glm::mat4 & a, const glm::mat4 & b)
+{
+    float difference = 0.0f;
+
+    for (int c = 0; c != 4; ++c)
+    {
+        for (int r = 0; r != 4; ++r)
+        {
+            difference = std::max(difference, std::abs(a[c][r] - b[c][r]));
+        }
+    }
+
+    return difference;
+}
+
+
+int main(int argc, char * argv[])
+{
+    int cameraCount = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> coordinate(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+
+    std::vector<CameraDescription> descriptions;
+    CameraSet cameraSet;
+
+    for (int i = 0; i != cameraCount; ++i)
+    {
+        glm::vec3 position(coordinate(generator), coordinate(generator), coordinate(generator));
+        glm::quat orientation = glm::normalize(glm::quat(component(generator), component(generator),
+                                                         component(generator), component(generator)));
+        bool orthographic = i % 2 != 0;
+
+        descriptions.push_back({position, orientation, orthographic});
+        CameraSet::Index index = cameraSet.add(position, orientation);
+
+        if (orthographic)
+        {
+            cameraSet.setOrthographic(index, -20.0f, 20.0f, -20.0f, 20.0f, 0.5f, 150.0f);
+        }
+        else
+        {
+            cameraSet.setPerspective(index, glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        }
+    }
+
+    glm::mat4 perspective = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 orthographic = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, 0.5f, 150.0f);
+
+    std::vector<glm::mat4> views(descriptions.size());
+    std::vector<glm::mat4> viewProjections(descriptions.size());
+    std::vector<Frustum> frustums(descriptions.size());
+
+    // what a renderer does per camera without a batch: lookAt, a full matrix product and the plane extraction
+    double scalarTime = medianMilliseconds(iterations, [&]()
+    {
+        for (std::size_t i = 0; i != descriptions.size(); ++i)
+        {
+            const CameraDescription & camera = descriptions[i];
+            glm::vec3 front = camera.orientation * glm::vec3(0.0f, 0.0f, -1.0f);
+            glm::vec3 up = camera.orientation * glm::vec3(0.0f, 1.0f, 0.0f);
+
+            views[i] = glm::lookAt(camera.position, camera.position + front, up);
+            viewProjections[i] = (camera.orthographic ? orthographic : perspective) * views[i];
+            frustums[i] = Frustum(viewProjections[i]);
+        }
+    });
+
+    double batchTime = medianMilliseconds(iterations, [&]()
+    {
+        cameraSet.update();
+    });
+
+    float viewError = 0.0f;
+    float viewProjectionError = 0.0f;
+    float planeError = 0.0f;
+
+    for (std::size_t i = 0; i != descriptions.size(); ++i)
+    {
+        auto index = static_cast<CameraSet::Index>(i);
+        viewError = std::max(viewError, maxDifference(views[i], cameraSet.getView(index)));
+        viewProjectionError = std::max(viewProjectionError,
+                                       maxDifference(viewProjections[i], cameraSet.getViewProjection(index)));
+
+        for (int p = 0; p != 6; ++p)
+        {
+            glm::vec4 difference = glm::abs(frustums[i].planes[p] - cameraSet.getFrustum(index).planes[p]);
+            planeError = std::max({planeError, difference.x, difference.y, difference.z, difference.w});
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(4)
+              << cameraCount << " cameras, median of " << iterations << " iterations\n"
+              << "per camera:  " << scalarTime << " ms\n"
+              << "CameraSet:   " << batchTime << " ms\n"
+              << std::scientific << std::setprecision(2)
+              << "largest difference: view " << viewError << ", view-projection " << viewProjectionError
+              << ", frustum planes " << planeError << '\n';
+
+    return 0;
+}
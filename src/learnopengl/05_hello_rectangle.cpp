@@ -3,20 +3,26 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "learnopengl/headless_capture.h"
+
 
 void framebuffer_size_callback(GLFWwindow * window, int width, int height);
 
 void processInput(GLFWwindow * window);
 
 
-int main()
+int main(int argc, char * argv[])
 {
+    // --capture / --golden render one fixed frame headless, see headless_capture.h
+    HeadlessCapture capture(argc, argv);
+
     // 1. OpenGL content by GLFW
 
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.applyWindowHints();
 
     GLFWwindow * window = glfwCreateWindow(800, 600, "OpenGLDemo", nullptr, nullptr);
 
@@ -239,6 +245,11 @@ int main()
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
         glBindVertexArray(0);
 
+        if (capture.endFrame(window))
+        {
+            glfwSetWindowShouldClose(window, true);
+        }
+
         // check and call events and swap the buffers
         glfwPollEvents();
         glfwSwapBuffers(window);
@@ -247,10 +258,11 @@ int main()
     // de-allocate all resources once they've outlived their purpose:
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
     glDeleteProgram(shaderProgram);
 
     glfwTerminate();
-    return 0;
+    return capture.getExitCode();
 }
 
 
@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "learnopengl/headless_capture.h"
 #include "learnopengl/shader.h"
 
 
@@ -16,14 +17,18 @@ const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
 
-int main()
+int main(int argc, char * argv[])
 {
+    // --capture / --golden render one fixed frame headless, see headless_capture.h
+    HeadlessCapture capture(argc, argv);
+
     // 1. OpenGL content by GLFW
 
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.applyWindowHints();
 
     GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
 
@@ -104,6 +109,11 @@ int main()
         glBindVertexArray(VAO);
         glDrawArrays(GL_TRIANGLES, 0, 3);
 
+        if (capture.endFrame(window))
+        {
+            glfwSetWindowShouldClose(window, true);
+        }
+
         // check and call events and swap the buffers
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -116,7 +126,7 @@ int main()
     glDeleteProgram(ourShader.getShaderProgramHandle());
     glfwTerminate();
 
-    return 0;
+    return capture.getExitCode();
 }
 
 
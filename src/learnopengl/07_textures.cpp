@@ -4,7 +4,9 @@
 #include <GLFW/glfw3.h>
 #include <opencv2/opencv.hpp>
 
+#include "learnopengl/headless_capture.h"
 #include "learnopengl/shader.h"
+#include "uniforms/TexturesUniforms.h"
 
 
 void framebuffer_size_callback(GLFWwindow * window, int width, int height);
@@ -17,14 +19,18 @@ const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
 
-int main()
+int main(int argc, char * argv[])
 {
+    // --capture / --golden render one fixed frame headless, see headless_capture.h
+    HeadlessCapture capture(argc, argv);
+
     // 1. OpenGL content by GLFW
 
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.applyWindowHints();
 
     GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
 
@@ -55,6 +61,7 @@ int main()
 
     // 3. build and compile our shader program
     Shader ourShader("src/shader/07_vert_shader.glsl", "src/shader/07_frag_shader.glsl");
+    TexturesUniforms uniforms(ourShader.getShaderProgramHandle());
 
     // 4. set up vertex data (and buffer(s)) and configure vertex attributes
 
@@ -162,8 +169,8 @@ int main()
 
     // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
     ourShader.use();  // don't forget to activate/use the shader before setting uniforms!
-    ourShader.setInt("texture1", 0);
-    ourShader.setInt("texture2", 1);
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
 
     // 6. render loop
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
@@ -188,6 +195,11 @@ int main()
         glBindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
+        if (capture.endFrame(window))
+        {
+            glfwSetWindowShouldClose(window, true);
+        }
+
         // check and call events and swap the buffers
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -196,10 +208,13 @@ int main()
     // 7. de-allocate all resources once they've outlived their purpose:
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteTextures(1, &texture1);
+    glDeleteTextures(1, &texture2);
     glDeleteProgram(ourShader.getShaderProgramHandle());
     glfwTerminate();
 
-    return 0;
+    return capture.getExitCode();
 }
 
 
@@ -4,7 +4,9 @@
 #include <GLFW/glfw3.h>
 #include <opencv2/opencv.hpp>
 
+#include "learnopengl/headless_capture.h"
 #include "learnopengl/shader.h"
+#include "uniforms/CoordinateSystemsUniforms.h"
 
 
 void framebuffer_size_callback(GLFWwindow * window, int width, int height);
@@ -17,14 +19,18 @@ const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
 
-int main()
+int main(int argc, char * argv[])
 {
+    // --capture / --golden render one fixed frame headless, see headless_capture.h
+    HeadlessCapture capture(argc, argv);
+
     // 1. OpenGL content by GLFW
 
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.applyWindowHints();
 
     GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
 
@@ -55,6 +61,7 @@ int main()
 
     // 3. build and compile our shader program
     Shader ourShader("src/shader/09_vert_shader.glsl", "src/shader/07_frag_shader.glsl");
+    CoordinateSystemsUniforms uniforms(ourShader.getShaderProgramHandle());
 
     // 4. set up vertex data (and buffer(s)) and configure vertex attributes
 
@@ -198,8 +205,8 @@ int main()
 
     // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
     ourShader.use();  // don't forget to activate/use the shader before setting uniforms!
-    ourShader.setInt("texture1", 0);
-    ourShader.setInt("texture2", 1);
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
 
     // 6. render loop
     glEnable(GL_DEPTH_TEST);
@@ -224,12 +231,12 @@ int main()
         // by translating the scene in the reverse direction
         glm::mat4 view = glm::mat4(1.0f);
         view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
-        ourShader.setMat4("view", view);
+        uniforms.view.set(view);
 
         // projection matrix
         glm::mat4 projection = glm::mat4(1.0f);
         projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        ourShader.setMat4("projection", projection);
+        uniforms.projection.set(projection);
 
         // render boxes
         glBindVertexArray(VAO);
@@ -241,12 +248,17 @@ int main()
             model = glm::translate(model, cubePositions[i]);
             float angle = 20.0f * static_cast<float>(i);
             model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            ourShader.setMat4("model", model);
+            uniforms.model.set(model);
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
 
+        if (capture.endFrame(window))
+        {
+            glfwSetWindowShouldClose(window, true);
+        }
+
         // check and call events and swap the buffers
         glfwSwapBuffers(window);
         glfwPollEvents();
@@ -255,10 +267,12 @@ int main()
     // 7. de-allocate all resources once they've outlived their purpose:
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    glDeleteTextures(1, &texture1);
+    glDeleteTextures(1, &texture2);
     glDeleteProgram(ourShader.getShaderProgramHandle());
     glfwTerminate();
 
-    return 0;
+    return capture.getExitCode();
 }
 
 
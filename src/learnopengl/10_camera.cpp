@@ -1,15 +1,36 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <opencv2/opencv.hpp>
 
 #include "learnopengl/camera.h"
+#include "learnopengl/dynamic_resolution.h"
+#include "learnopengl/fixed_timestep.h"
+#include "learnopengl/frame_capture.h"
+#include "learnopengl/frame_pacer.h"
+#include "learnopengl/gl_resource.h"
+#include "learnopengl/headless_capture.h"
+#include "learnopengl/input_recorder.h"
 #include "learnopengl/shader.h"
+#include "learnopengl/shader_watcher.h"
+#include "learnopengl/transform_store.h"
+#include "uniforms/CameraUniforms.h"
+#include "uniforms/UpscaleUniforms.h"
 
 
+void applyPendingInput();
+
 void framebuffer_size_callback(GLFWwindow * window, int width, int height);
 
+bool isKeyDown(GLFWwindow * window, int key);
+
 void mouse_callback(GLFWwindow * window, double xpos, double ypos);
 
 void mouse_button_callback(GLFWwindow * window, int button, int action, int mods);
@@ -22,8 +43,9 @@ void scroll_callback(GLFWwindow * window, double xoffset, double yoffset);
 const unsigned int SCR_WIDTH = 800;
 const unsigned int SCR_HEIGHT = 600;
 
-// camera
+// camera: the state of the last fixed update and of the one before, rendered in between
 Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+Camera previousCamera = camera;
 
 // mouse
 bool mousePressed = false;
@@ -31,19 +53,124 @@ bool firstMouse = true;
 float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 
+// mouse and scroll input gathered by the callbacks since the last fixed update, which applies and clears it
+float pendingXOffset = 0.0f;
+float pendingYOffset = 0.0f;
+float pendingScroll = 0.0f;
+
 // timing
-float deltaTime = 0.0f;     // time between current frame and last frame
+float deltaTime = 0.0f;     // time step of one fixed update
 float lastFrame = 0.0f;
 
+// input: logged with --record-input, or replayed in fixed steps with --replay-input, see input_recorder.h
+InputLog inputLog;
+bool recordingInput = false;
+std::unique_ptr<InputReplay> inputReplay;
+
+// what input is logged at: simulation time, the middle of the fixed update applying it, so it replays in the same
+// update however the times are rounded
+double inputTime = 0.0;
+
 
-int main()
+int main(int argc, char * argv[])
 {
+    // --capture / --golden render one fixed frame headless, see headless_capture.h
+    HeadlessCapture capture(argc, argv);
+
+    // --record <file> records the session as video, raw Y4M when the name ends in .y4m, see frame_capture.h
+    const char * recordPath = nullptr;
+
+    // --record-input <log> saves the camera input, --replay-input <log> drives the camera from it instead
+    const char * recordInputPath = nullptr;
+    const char * replayInputPath = nullptr;
+
+    // --update-rate <hz> of the fixed simulation updates, --spin <degrees per second> turns the scene about its root
+    double updateRate = 120.0;
+    float spinSpeed = 0.0f;
+
+    // --vsync off|on|adaptive and --fps-cap <fps> (0 for none) pace the frames, see frame_pacer.h
+    VsyncMode vsync = VsyncMode::On;
+    double fpsCap = 0.0;
+
+    // --dynamic-resolution <ms> scales the scene resolution to that GPU time, --upscale bilinear|sharpen
+    double dynamicResolutionTarget = 0.0;
+    UpscaleFilter upscaleFilter = UpscaleFilter::Sharpen;
+
+    // --depth standard|reverse: the usual [-1, 1] depth with the far plane at 100 (the default), or reverse-Z with an
+    // infinite far plane in a float depth buffer, where GL_ARB_clip_control is available
+    bool reverseDepth = false;
+
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--record"))
+        {
+            recordPath = argv[i + 1];
+        }
+        else if (!std::strcmp(argv[i], "--record-input"))
+        {
+            recordInputPath = argv[i + 1];
+        }
+        else if (!std::strcmp(argv[i], "--replay-input"))
+        {
+            replayInputPath = argv[i + 1];
+        }
+        else if (!std::strcmp(argv[i], "--update-rate"))
+        {
+            updateRate = std::atof(argv[i + 1]);
+        }
+        else if (!std::strcmp(argv[i], "--spin"))
+        {
+            spinSpeed = static_cast<float>(std::atof(argv[i + 1]));
+        }
+        else if (!std::strcmp(argv[i], "--vsync") && !FramePacer::parseMode(argv[i + 1], vsync))
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "--vsync takes off, on or adaptive!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+        else if (!std::strcmp(argv[i], "--fps-cap"))
+        {
+            fpsCap = std::atof(argv[i + 1]);
+        }
+        else if (!std::strcmp(argv[i], "--dynamic-resolution"))
+        {
+            dynamicResolutionTarget = std::atof(argv[i + 1]) / 1000.0;
+        }
+        else if (!std::strcmp(argv[i], "--upscale") && !DynamicResolution::parseFilter(argv[i + 1], upscaleFilter))
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "--upscale takes bilinear or sharpen!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+        else if (!std::strcmp(argv[i], "--depth"))
+        {
+            if (std::strcmp(argv[i + 1], "reverse") && std::strcmp(argv[i + 1], "standard"))
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "--depth takes standard or reverse!"
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+
+            reverseDepth = !std::strcmp(argv[i + 1], "reverse");
+        }
+    }
+
     // 1. OpenGL content by GLFW
 
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    capture.applyWindowHints();
 
     GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
 
@@ -78,6 +205,17 @@ int main()
     // 3. build and compile our shader program
     Shader ourShader("src/shader/09_vert_shader.glsl", "src/shader/07_frag_shader.glsl");
 
+    // uniform locations, generated from the shader sources at build time
+    CameraUniforms uniforms(ourShader.getShaderProgramHandle());
+
+    // recompile on save; held by pointer so its shared context is destroyed before glfwTerminate
+    auto shaderWatcher = std::make_unique<ShaderWatcher>(window);
+    shaderWatcher->watch(ourShader, "src/shader/09_vert_shader.glsl", "src/shader/07_frag_shader.glsl",
+                         [&uniforms](Shader & shader)
+                         {
+                             uniforms = CameraUniforms(shader.getShaderProgramHandle());
+                         });
+
     // 4. set up vertex data (and buffer(s)) and configure vertex attributes
 
     float vertices[] = {
@@ -138,14 +276,25 @@ int main()
             glm::vec3(-1.3f, 1.0f, -1.5f)
     };
 
-    unsigned int VAO;
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
+    // the cubes hang below one scene root; unless it spins nothing moves, so after the first update() no matrix is
+    // recomputed
+    TransformStore transforms;
+    TransformStore::Handle sceneRoot = transforms.create();
+    TransformStore::Handle cubes[10];
+
+    for (unsigned int i = 0; i < 10; i++)
+    {
+        float angle = 20.0f * static_cast<float>(i);
+        cubes[i] = transforms.create(sceneRoot, cubePositions[i],
+                                     glm::angleAxis(glm::radians(angle), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f))));
+    }
+
+    // owned by wrappers that delete them and account their memory, see gl_resource.h
+    GlVertexArray VAO(GlCategory::Geometry, "cube vertex array");
+    glBindVertexArray(VAO.get());
 
-    unsigned int VBO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    GlBuffer VBO(GlCategory::Geometry, "cube vertices");
+    VBO.allocate(GL_ARRAY_BUFFER, sizeof(vertices), GL_STATIC_DRAW, vertices);
 
     // position attribute
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(0));
@@ -163,9 +312,8 @@ int main()
     // 5. texture
 
     // texture 1
-    unsigned int texture1;
-    glGenTextures(1, &texture1);
-    glBindTexture(GL_TEXTURE_2D, texture1);
+    GlTexture texture1(GlCategory::Texture, "etc/brick.jpg");
+    glBindTexture(GL_TEXTURE_2D, texture1.get());
 
     // set texture parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -186,14 +334,14 @@ int main()
         std::abort();
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, brick.cols, brick.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, brick.data);
+    texture1.allocate2D(GL_RGB8, brick.cols, brick.rows, GlTexture::getLevelCount(brick.cols, brick.rows), GL_RGB,
+                        GL_UNSIGNED_BYTE, brick.data);
     glGenerateMipmap(GL_TEXTURE_2D);
     brick.release();
 
     // texture 2
-    unsigned int texture2;
-    glGenTextures(1, &texture2);
-    glBindTexture(GL_TEXTURE_2D, texture2);
+    GlTexture texture2(GlCategory::Texture, "etc/tree.jpg");
+    glBindTexture(GL_TEXTURE_2D, texture2.get());
 
     // set texture parameters
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -214,28 +362,186 @@ int main()
         std::abort();
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, tree.cols, tree.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, tree.data);
+    texture2.allocate2D(GL_RGB8, tree.cols, tree.rows, GlTexture::getLevelCount(tree.cols, tree.rows), GL_RGB,
+                        GL_UNSIGNED_BYTE, tree.data);
     glGenerateMipmap(GL_TEXTURE_2D);
     tree.release();
 
     // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
     ourShader.use();  // don't forget to activate/use the shader before setting uniforms!
-    ourShader.setInt("texture1", 0);
-    ourShader.setInt("texture2", 1);
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
 
     // 6. render loop
     glEnable(GL_DEPTH_TEST);
+
+    if (reverseDepth && !enableReverseDepth())
+    {
+        std::cout << "GL_ARB_clip_control is not supported, using standard depth" << std::endl;
+        reverseDepth = false;
+    }
+
+    camera.Depth = reverseDepth ? ProjectionDepth::ReverseInfinite : ProjectionDepth::Standard;
+
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
 
+    std::unique_ptr<FrameCapture> recorder;
+
+    if (recordPath)
+    {
+        int width;
+        int height;
+        glfwGetFramebufferSize(window, &width, &height);
+        recorder = std::make_unique<FrameCapture>(recordPath, width, height);
+    }
+
+    if (replayInputPath)
+    {
+        // a replay runs at the rate the input was recorded at, whatever --update-rate says
+        inputLog.load(replayInputPath);
+
+        if (std::abs(1.0 / inputLog.getStep() - updateRate) > 1e-9 * updateRate)
+        {
+            std::cout << "[INFO] " << replayInputPath << " was recorded at " << 1.0 / inputLog.getStep()
+                      << " updates per second, replaying at that rate" << std::endl;
+        }
+
+        updateRate = 1.0 / inputLog.getStep();
+    }
+
+    // simulation (input, camera motion, the spin) runs in fixed updates, rendering interpolates between the last two
+    FixedTimestep timestep(updateRate);
+    deltaTime = static_cast<float>(timestep.getStep());
+
+    float spinAngle = 0.0f;
+    float previousSpinAngle = 0.0f;
+
+    if (replayInputPath)
+    {
+        // one logged step per update
+        inputReplay = std::make_unique<InputReplay>(inputLog);
+    }
+    else if (recordInputPath)
+    {
+        inputLog.begin(0.0, timestep.getStep());
+        recordingInput = true;
+    }
+
+    unsigned long long fixedUpdates = 0;
+
+    // the scene goes through an offscreen framebuffer with --dynamic-resolution, and for reverse-Z, which needs a float
+    // depth buffer the default framebuffer does not have; without a time target it stays at full scale
+    std::unique_ptr<DynamicResolution> dynamicResolution;
+    std::unique_ptr<Shader> upscaleShader;
+    std::unique_ptr<UpscaleUniforms> upscaleUniforms;
+
+    if (dynamicResolutionTarget > 0.0 || reverseDepth)
+    {
+        DynamicResolutionSettings settings;
+
+        if (dynamicResolutionTarget > 0.0)
+        {
+            settings.targetTime = dynamicResolutionTarget;
+        }
+        else
+        {
+            settings.minScale = 1.0f;
+            upscaleFilter = UpscaleFilter::Bilinear;
+        }
+
+        if (reverseDepth)
+        {
+            settings.depthFormat = GL_DEPTH_COMPONENT32F;
+        }
+
+        dynamicResolution = std::make_unique<DynamicResolution>(settings);
+        upscaleShader = std::make_unique<Shader>("src/shader/10_upscale_vert_shader.glsl",
+                                                 "src/shader/10_upscale_frag_shader.glsl");
+        upscaleUniforms = std::make_unique<UpscaleUniforms>(upscaleShader->getShaderProgramHandle());
+    }
+
+    FramePacer pacer(vsync, fpsCap);
+    pacer.apply();
+    float titleTime = 0.0f;
+
+    double loopStart = glfwGetTime();
+    lastFrame = static_cast<float>(capture.getTime());
+
     while (!glfwWindowShouldClose(window))
     {
-        // per-frame time logic
-        auto currentFrame = static_cast<float>(glfwGetTime());
-        deltaTime = currentFrame - lastFrame;
+        // wait out the FPS cap, then take the events: input is sampled as late as possible before drawing
+        pacer.beginFrame();
+        glfwPollEvents();
+
+        // per-frame time logic; a replay takes one update per frame, whatever the frame took
+        auto currentFrame = static_cast<float>(capture.getTime());
+        double frameTime = inputReplay ? timestep.getStep() : currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        // process input
-        processInput(window);
+        // swap in shaders recompiled since the last frame
+        shaderWatcher->poll();
+
+        // fixed updates
+        int updates = timestep.advance(frameTime);
+
+        for (int update = 0; update < updates; ++update)
+        {
+            previousCamera = camera;
+            previousSpinAngle = spinAngle;
+            inputTime = (static_cast<double>(++fixedUpdates) - 0.5) * timestep.getStep();
+
+            if (inputReplay)
+            {
+                // the replayed keys are applied in processInput
+                bool replaying = inputReplay->advance([](const InputEvent & event)
+                                                      {
+                                                          if (event.type == InputEventType::MouseMove)
+                                                          {
+                                                              camera.ProcessMouseMovement(event.x, event.y);
+                                                          }
+                                                          else
+                                                          {
+                                                              camera.ProcessMouseScroll(event.y);
+                                                          }
+                                                      });
+
+                // the log ends where the recording's updates did, so this update is not run
+                if (!replaying)
+                {
+                    glfwSetWindowShouldClose(window, true);
+                    break;
+                }
+            }
+            else
+            {
+                applyPendingInput();
+            }
+
+            processInput(window);
+            spinAngle += spinSpeed * deltaTime;
+        }
+
+        // the state to draw, between the last two updates
+        float alpha = timestep.getAlpha();
+        Camera view = Camera::Interpolate(previousCamera, camera, alpha);
+
+        if (spinSpeed != 0.0f)
+        {
+            float angle = previousSpinAngle + (spinAngle - previousSpinAngle) * alpha;
+            transforms.setRotation(sceneRoot, glm::angleAxis(glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f)));
+        }
+
+        // the render target keeps the window's aspect, also when dynamic resolution renders only part of it
+        int framebufferWidth;
+        int framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        float framebufferAspect = static_cast<float>(std::max(framebufferWidth, 1)) /
+                                  static_cast<float>(std::max(framebufferHeight, 1));
+
+        if (dynamicResolution)
+        {
+            dynamicResolution->beginFrame(framebufferWidth, framebufferHeight);
+        }
 
         // background
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
@@ -243,46 +549,148 @@ int main()
 
         // bind textures on corresponding texture units
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
+        glBindTexture(GL_TEXTURE_2D, texture1.get());
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
+        glBindTexture(GL_TEXTURE_2D, texture2.get());
 
-        // pass projection matrix to shader (note that in this case it could change every frame)
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float) SCR_WIDTH / (float) SCR_HEIGHT, 0.1f,
-                                                100.0f);
-        ourShader.setMat4("projection", projection);
+        // pass projection matrix to shader, with the interpolated zoom (cached by the camera, rebuilt only when the
+        // zoom or the aspect changes)
+        uniforms.projection.set(view.GetProjectionMatrix(framebufferAspect, 0.1f, 100.0f));
 
         // camera/view transformation
-        glm::mat4 view = camera.GetViewMatrix();
-        ourShader.setMat4("view", view);
+        uniforms.view.set(view.GetViewMatrix());
 
         // render boxes
-        glBindVertexArray(VAO);
+        transforms.update();
+        glBindVertexArray(VAO.get());
 
         for (unsigned int i = 0; i < 10; i++)
         {
-            // calculate the model matrix for each object and pass it to shader before drawing
-            glm::mat4 model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
-            model = glm::translate(model, cubePositions[i]);
-            float angle = 20.0f * static_cast<float>(i);
-            model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            ourShader.setMat4("model", model);
+            // the model matrix of each object comes from the transform store
+            uniforms.model.set(transforms.getWorld(cubes[i]));
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
 
-        // check and call events and swap the buffers
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        if (dynamicResolution)
+        {
+            dynamicResolution->endFrame(*upscaleShader, *upscaleUniforms, upscaleFilter);
+        }
+
+        if (capture.endFrame(window))
+        {
+            glfwSetWindowShouldClose(window, true);
+        }
+
+        if (recorder)
+        {
+            recorder->capture();
+        }
+
+        // swap the buffers
+        pacer.endFrame(window);
+
+        if (currentFrame - titleTime >= 1.0f)
+        {
+            titleTime = currentFrame;
+            FramePacer::Stats stats = pacer.getStats();
+            char title[192];
+            int length = std::snprintf(title, sizeof(title),
+                                       "OpenGLDemo - %.1f fps, input to present %.1f ms (max %.1f ms)",
+                                       stats.fps, stats.latency * 1000.0, stats.maxLatency * 1000.0);
+
+            if (dynamicResolutionTarget > 0.0)
+            {
+                std::snprintf(title + length, sizeof(title) - length, ", scale %.0f%%, scene %.2f ms on the GPU",
+                              dynamicResolution->getScale() * 100.0f, dynamicResolution->getGpuTime() * 1000.0);
+            }
+
+            glfwSetWindowTitle(window, title);
+        }
+    }
+
+    if (recordingInput)
+    {
+        // the replay stops before the update after the last recorded one
+        inputLog.save(recordInputPath, (static_cast<double>(fixedUpdates) + 0.5) * timestep.getStep());
+        std::cout << "recorded " << inputLog.getEvents().size() << " input events to " << recordInputPath << std::endl;
+    }
+
+    if (timestep.getClampedFrames())
+    {
+        std::cout << timestep.getClampedFrames() << " frames exceeded the update budget, "
+                  << timestep.getDroppedTime() << " s of simulation skipped" << std::endl;
+    }
+
+    if (inputReplay)
+    {
+        // the final camera position is the same on every run; the time is what the replay measures
+        double seconds = glfwGetTime() - loopStart;
+        std::cout << "replayed " << inputReplay->getSteps() << " steps in " << seconds << " s ("
+                  << seconds * 1000.0 / static_cast<double>(inputReplay->getSteps()) << " ms per frame), camera at "
+                  << camera.Position.x << ' ' << camera.Position.y << ' ' << camera.Position.z << std::endl;
     }
 
     // 7. de-allocate all resources once they've outlived their purpose:
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    if (recorder)
+    {
+        recorder->finish();
+
+        FrameCapture::Stats stats = recorder->getStats();
+        std::cout << "recorded " << stats.written << " frames to " << recordPath << ", dropped " << stats.dropped
+                  << std::endl;
+
+        recorder.reset();
+    }
+
+    GlResourceTracker::instance().printReport();
+    VAO.reset();
+    VBO.reset();
+    texture1.reset();
+    texture2.reset();
     glDeleteProgram(ourShader.getShaderProgramHandle());
+    pacer.release();
+    dynamicResolution.reset();
+
+    if (upscaleShader)
+    {
+        glDeleteProgram(upscaleShader->getShaderProgramHandle());
+    }
+
+    shaderWatcher.reset();
+    GlResourceTracker::instance().reportLeaks();
     glfwTerminate();
 
-    return 0;
+    return capture.getExitCode();
+}
+
+
+// the mouse and scroll input since the last fixed update, applied in one step so only updates move the camera
+void applyPendingInput()
+{
+    if (pendingXOffset != 0.0f || pendingYOffset != 0.0f)
+    {
+        camera.ProcessMouseMovement(pendingXOffset, pendingYOffset);
+
+        if (recordingInput)
+        {
+            inputLog.mouseMove(inputTime, pendingXOffset, pendingYOffset);
+        }
+    }
+
+    if (pendingScroll != 0.0f)
+    {
+        camera.ProcessMouseScroll(pendingScroll);
+
+        if (recordingInput)
+        {
+            inputLog.scroll(inputTime, pendingScroll);
+        }
+    }
+
+    pendingXOffset = 0.0f;
+    pendingYOffset = 0.0f;
+    pendingScroll = 0.0f;
 }
 
 
@@ -292,6 +700,25 @@ void framebuffer_size_callback(GLFWwindow * window, int width, int height)
 }
 
 
+// the live key state, logged while recording input, or the replayed one
+bool isKeyDown(GLFWwindow * window, int key)
+{
+    if (inputReplay)
+    {
+        return inputReplay->isKeyDown(key);
+    }
+
+    bool down = glfwGetKey(window, key) == GLFW_PRESS;
+
+    if (recordingInput)
+    {
+        inputLog.setKey(inputTime, key, down);
+    }
+
+    return down;
+}
+
+
 void processInput(GLFWwindow * window)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
@@ -299,22 +726,22 @@ void processInput(GLFWwindow * window)
         glfwSetWindowShouldClose(window, true);
     }
 
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    if (isKeyDown(window, GLFW_KEY_W))
     {
         camera.ProcessKeyboard(FORWARD, deltaTime);
     }
 
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    if (isKeyDown(window, GLFW_KEY_S))
     {
         camera.ProcessKeyboard(BACKWARD, deltaTime);
     }
 
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    if (isKeyDown(window, GLFW_KEY_A))
     {
         camera.ProcessKeyboard(LEFT, deltaTime);
     }
 
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    if (isKeyDown(window, GLFW_KEY_D))
     {
         camera.ProcessKeyboard(RIGHT, deltaTime);
     }
@@ -349,14 +776,19 @@ void mouse_callback(GLFWwindow * window, double xpos, double ypos)
     lastX = xpos;
     lastY = ypos;
 
-    if (mousePressed)
+    // a replay ignores the live mouse
+    if (mousePressed && !inputReplay)
     {
-        camera.ProcessMouseMovement(xoffset, yoffset);
+        pendingXOffset += xoffset;
+        pendingYOffset += yoffset;
     }
 }
 
 
 void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
 {
-    camera.ProcessMouseScroll(yoffset);
+    if (!inputReplay)
+    {
+        pendingScroll += static_cast<float>(yoffset);
+    }
 }
\ No newline at end of file
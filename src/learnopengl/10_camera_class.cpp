@@ -6,6 +6,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <learnopengl/camera.h>
+#include "uniforms/CameraUniforms.h"
 
 #include <iostream>
 
@@ -73,6 +74,7 @@ int main()
     // build and compile our shader zprogram
     // ------------------------------------
     Shader ourShader("7.4.camera.vs", "7.4.camera.fs");
+    CameraUniforms uniforms(ourShader.getShaderProgramHandle());
 
     // set up vertex data (and buffer(s)) and configure vertex attributes
     // ------------------------------------------------------------------
@@ -203,8 +205,8 @@ int main()
     // tell opengl for each sampler to which texture unit it belongs to (only has to be done once)
     // -------------------------------------------------------------------------------------------
     ourShader.use();
-    ourShader.setInt("texture1", 0);
-    ourShader.setInt("texture2", 1);
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
 
 
     // render loop
@@ -237,11 +239,11 @@ int main()
 
         // pass projection matrix to shader (note that in this case it could change every frame)
         glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        ourShader.setMat4("projection", projection);
+        uniforms.projection.set(projection);
 
         // camera/view transformation
         glm::mat4 view = camera.GetViewMatrix();
-        ourShader.setMat4("view", view);
+        uniforms.view.set(view);
 
         // render boxes
         glBindVertexArray(VAO);
@@ -252,7 +254,7 @@ int main()
             model = glm::translate(model, cubePositions[i]);
             float angle = 20.0f * i;
             model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-            ourShader.setMat4("model", model);
+            uniforms.model.set(model);
 
             glDrawArrays(GL_TRIANGLES, 0, 36);
         }
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <opencv2/opencv.hpp>
+
+#include "learnopengl/camera.h"
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_batch.h"
+#include "learnopengl/shader_preprocessor.h"
+#include "learnopengl/virtual_texture.h"
+#include "uniforms/VirtualTextureFeedbackUniforms.h"
+#include "uniforms/VirtualTextureUniforms.h"
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height);
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos);
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods);
+
+void processInput(GLFWwindow * window);
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset);
+
+
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+// mouse
+bool mousePressed = false;
+bool firstMouse = true;
+float lastX = SCR_WIDTH / 2.0f;
+float lastY = SCR_HEIGHT / 2.0f;
+
+// timing
+float deltaTime = 0.0f;     // time between current frame and last frame
+float lastFrame = 0.0f;
+
+
+// usage: 11_virtual_texture [image] -- the page file "<image>.vtpf" is baked on first run
+int main(int argc, char * argv[])
+{
+    std::string imagePath = argc > 1 ? argv[1] : "etc/brick.jpg";
+    std::string pageFilePath = imagePath + ".vtpf";
+
+    // 0. offline tiling (only once; afterwards the image itself is never decoded again)
+
+    if (!std::ifstream(pageFilePath))
+    {
+        VirtualTexture::bake(imagePath.c_str(), pageFilePath.c_str());
+    }
+
+    // 1. OpenGL content by GLFW
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
+
+    if (!window)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to create GLFW window!"
+                  << std::nounitbuf << std::endl;
+        glfwTerminate();
+        std::abort();
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // 2. load OpenGL functions by GLAD
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to initialize GLAD!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // 3. submit our shader programs; they compile while the page file is opened and the geometry is set up
+    //    (the feedback program is the VT_FEEDBACK permutation of the same fragment shader)
+    ShaderPreprocessor preprocessor;
+    std::string vertShaderCode = preprocessor.process("src/shader/09_vert_shader.glsl").code;
+
+    ShaderBatch shaderBatch;
+    std::size_t ourShaderIndex =
+            shaderBatch.addSource(vertShaderCode, preprocessor.process("src/shader/11_frag_shader.glsl").code);
+    std::size_t feedbackShaderIndex =
+            shaderBatch.addSource(vertShaderCode, preprocessor.process("src/shader/11_frag_shader.glsl",
+                                                                       {"VT_FEEDBACK"}).code);
+
+    // 4. virtual texture: page cache, I/O threads and the feedback target
+
+    // (held by pointer so their GL objects are released before the context goes away)
+    auto virtualTexture = std::make_unique<VirtualTexture>(pageFilePath.c_str());
+    auto feedback = std::make_unique<VirtualTextureFeedback>(framebufferWidth, framebufferHeight);
+    int feedbackWidth = framebufferWidth;
+    int feedbackHeight = framebufferHeight;
+
+    const VirtualTexture::PageFileHeader & header = virtualTexture->getHeader();
+    float aspect = static_cast<float>(header.width) / static_cast<float>(header.height);
+
+    // 5. a single quad with the image's aspect ratio
+
+    float vertices[] = {
+            // positions                // texture coords
+             aspect,  1.0f, 0.0f,       1.0f, 1.0f,  // top right
+             aspect, -1.0f, 0.0f,       1.0f, 0.0f,  // bottom right
+            -aspect, -1.0f, 0.0f,       0.0f, 0.0f,  // bottom left
+            -aspect,  1.0f, 0.0f,       0.0f, 1.0f   // top left
+    };
+
+    unsigned int indices[] = {
+            0, 1, 3, // first triangle
+            1, 2, 3  // second triangle
+    };
+
+    unsigned int VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    unsigned int VBO;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    unsigned int EBO;
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(0));
+    glEnableVertexAttribArray(0);
+
+    // texture coord attribute
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // (optional) unbind VAO and VBO from context, but NOT the EBO while the VAO is bound
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 6. render loop
+
+    // first use of the programs: only now wait for their compilation
+    Shader ourShader = shaderBatch.get(ourShaderIndex);
+    Shader feedbackShader = shaderBatch.get(feedbackShaderIndex);
+    VirtualTextureUniforms uniforms(ourShader.getShaderProgramHandle());
+    VirtualTextureFeedbackUniforms feedbackUniforms(feedbackShader.getShaderProgramHandle());
+
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        auto currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // process input
+        processInput(window);
+
+        // the feedback target follows the framebuffer, so its pixels keep covering the same share of the screen
+        if (framebufferWidth != feedbackWidth || framebufferHeight != feedbackHeight)
+        {
+            feedback = std::make_unique<VirtualTextureFeedback>(framebufferWidth, framebufferHeight);
+            feedbackWidth = framebufferWidth;
+            feedbackHeight = framebufferHeight;
+        }
+
+        float screenAspect = static_cast<float>(framebufferWidth) / static_cast<float>(std::max(framebufferHeight, 1));
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), screenAspect, 0.1f, 100.0f);
+        glm::mat4 view = camera.GetViewMatrix();
+        glm::mat4 model = glm::mat4(1.0f);
+
+        // feedback pass: which pages at which level does this view need?
+        feedback->begin(feedbackShader, feedbackUniforms, *virtualTexture);
+        feedbackUniforms.projection.set(projection);
+        feedbackUniforms.view.set(view);
+        feedbackUniforms.model.set(model);
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        feedback->end(*virtualTexture, framebufferWidth, framebufferHeight);
+
+        // upload pages streamed in since the last frame
+        virtualTexture->update();
+
+        // background
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // main pass
+        ourShader.use();
+        virtualTexture->bind(uniforms);
+        uniforms.projection.set(projection);
+        uniforms.view.set(view);
+        uniforms.model.set(model);
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+
+        // check and call events and swap the buffers
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // 7. de-allocate all resources once they've outlived their purpose:
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteProgram(ourShader.getShaderProgramHandle());
+    glDeleteProgram(feedbackShader.getShaderProgramHandle());
+    feedback.reset();
+    virtualTexture.reset();
+    glfwTerminate();
+
+    return 0;
+}
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height)
+{
+    framebufferWidth = width;
+    framebufferHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+
+void processInput(GLFWwindow * window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    {
+        glfwSetWindowShouldClose(window, true);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+    }
+}
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods)
+{
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    {
+        mousePressed = true;
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+    {
+        mousePressed = false;
+    }
+}
+
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;  // reversed since y-coordinates go from bottom to top
+
+    lastX = xpos;
+    lastY = ypos;
+
+    if (mousePressed)
+    {
+        camera.ProcessMouseMovement(xoffset, yoffset);
+    }
+}
+
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,780 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <opencv2/opencv.hpp>
+
+#include "learnopengl/camera.h"
+#include "learnopengl/command_list.h"
+#include "learnopengl/ecs.h"
+#define LEARNOPENGL_COUNT_ALLOCATIONS
+#include "learnopengl/frame_arena.h"
+#include "learnopengl/hiz.h"
+#include "learnopengl/job_system.h"
+#include "learnopengl/render_thread.h"
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_preprocessor.h"
+#include "uniforms/HiZUniforms.h"
+#include "uniforms/SceneUniforms.h"
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height);
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos);
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods);
+
+void processInput(GLFWwindow * window);
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset);
+
+unsigned int loadTexture(const cv::Mat & image);
+
+cv::Mat decodeImage(const char * path);
+
+
+// everything the render thread needs to draw one frame; produced by the main (simulation) thread
+struct FramePacket
+{
+    int width;
+    int height;
+    glm::mat4 projection;
+    glm::mat4 view;
+    CommandList commands;   // merged from the per-thread lists and sorted by state key
+    FrameArenas arenas;     // per-thread storage of this frame's model matrices, reset when the slot is reused
+    bool buildHiZ;          // whether the render thread builds and reads back the depth pyramid of this frame
+};
+
+
+// where occlusion culling gets its depth from
+enum class OcclusionMode
+{
+    Off,
+    Gpu,        // the previous frame's depth buffer, reduced to a pyramid on the GPU and read back
+    Cpu         // the nearest cubes, rasterized in software this frame
+};
+
+
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+// written by the framebuffer callback on the main thread, consumed through the frame packets
+std::atomic<int> framebufferWidth {SCR_WIDTH};
+std::atomic<int> framebufferHeight {SCR_HEIGHT};
+
+// camera
+Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+// mouse
+bool mousePressed = false;
+bool firstMouse = true;
+float lastX = SCR_WIDTH / 2.0f;
+float lastY = SCR_HEIGHT / 2.0f;
+
+// timing
+float deltaTime = 0.0f;     // time between current frame and last frame
+float lastFrame = 0.0f;
+
+
+// usage: 12_render_thread [--pacing block|latest] [--simulate-ms N] [--cubes N] [--occlusion off|gpu|cpu]
+// --cubes is per side of the grid; e.g. 47 for about 100k entities
+int main(int argc, char * argv[])
+{
+    FramePacing pacing = FramePacing::Block;
+    int simulateMs = 0;         // artificial simulation cost per frame, to show it no longer stalls presentation
+    int cubesPerSide = 10;      // the scene is a cubesPerSide^3 grid of cubes
+    OcclusionMode occlusion = OcclusionMode::Gpu;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!std::strcmp(argv[i], "--pacing"))
+        {
+            if (!std::strcmp(argv[i + 1], "block"))
+            {
+                pacing = FramePacing::Block;
+            }
+            else if (!std::strcmp(argv[i + 1], "latest"))
+            {
+                pacing = FramePacing::Latest;
+            }
+            else
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "--pacing takes block or latest!"
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+        }
+        else if (!std::strcmp(argv[i], "--simulate-ms"))
+        {
+            simulateMs = std::stoi(argv[i + 1]);
+        }
+        else if (!std::strcmp(argv[i], "--cubes"))
+        {
+            cubesPerSide = std::stoi(argv[i + 1]);
+        }
+        else if (!std::strcmp(argv[i], "--occlusion"))
+        {
+            if (!std::strcmp(argv[i + 1], "off"))
+            {
+                occlusion = OcclusionMode::Off;
+            }
+            else if (!std::strcmp(argv[i + 1], "gpu"))
+            {
+                occlusion = OcclusionMode::Gpu;
+            }
+            else if (!std::strcmp(argv[i + 1], "cpu"))
+            {
+                occlusion = OcclusionMode::Cpu;
+            }
+            else
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "--occlusion takes off, gpu or cpu!"
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+        }
+    }
+
+    // 1. OpenGL content by GLFW
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
+
+    if (!window)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to create GLFW window!"
+                  << std::nounitbuf << std::endl;
+        glfwTerminate();
+        std::abort();
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // 2. load OpenGL functions by GLAD
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to initialize GLAD!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // 3. build and compile our shader program
+    ShaderCache shaderCache;
+    Shader ourShader = shaderCache.get("src/shader/09_vert_shader.glsl", "src/shader/07_frag_shader.glsl");
+    SceneUniforms uniforms(ourShader.getShaderProgramHandle());
+    Shader hizShader = shaderCache.get("src/shader/12_hiz_vert_shader.glsl", "src/shader/12_hiz_frag_shader.glsl");
+    HiZUniforms hizUniforms(hizShader.getShaderProgramHandle());
+
+    // 4. set up vertex data (and buffer(s)) and configure vertex attributes
+
+    float vertices[] = {
+            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
+            0.5f, -0.5f, -0.5f, 1.0f, 0.0f,
+            0.5f, 0.5f, -0.5f, 1.0f, 1.0f,
+            0.5f, 0.5f, -0.5f, 1.0f, 1.0f,
+            -0.5f, 0.5f, -0.5f, 0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
+
+            -0.5f, -0.5f, 0.5f, 0.0f, 0.0f,
+            0.5f, -0.5f, 0.5f, 1.0f, 0.0f,
+            0.5f, 0.5f, 0.5f, 1.0f, 1.0f,
+            0.5f, 0.5f, 0.5f, 1.0f, 1.0f,
+            -0.5f, 0.5f, 0.5f, 0.0f, 1.0f,
+            -0.5f, -0.5f, 0.5f, 0.0f, 0.0f,
+
+            -0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+            -0.5f, 0.5f, -0.5f, 1.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+            -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+            -0.5f, -0.5f, 0.5f, 0.0f, 0.0f,
+            -0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+
+            0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+            0.5f, 0.5f, -0.5f, 1.0f, 1.0f,
+            0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+            0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+            0.5f, -0.5f, 0.5f, 0.0f, 0.0f,
+            0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+
+            -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+            0.5f, -0.5f, -0.5f, 1.0f, 1.0f,
+            0.5f, -0.5f, 0.5f, 1.0f, 0.0f,
+            0.5f, -0.5f, 0.5f, 1.0f, 0.0f,
+            -0.5f, -0.5f, 0.5f, 0.0f, 0.0f,
+            -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+
+            -0.5f, 0.5f, -0.5f, 0.0f, 1.0f,
+            0.5f, 0.5f, -0.5f, 1.0f, 1.0f,
+            0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+            0.5f, 0.5f, 0.5f, 1.0f, 0.0f,
+            -0.5f, 0.5f, 0.5f, 0.0f, 0.0f,
+            -0.5f, 0.5f, -0.5f, 0.0f, 1.0f
+    };
+
+    unsigned int VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    unsigned int VBO;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(0));
+    glEnableVertexAttribArray(0);
+
+    // texture coord attribute
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // (optional) unbind VAO and VBO from context
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // 5. texture: decoding runs on the job system, only the uploads need the context; every job thread counts its
+    // heap allocations into the slot of its thread index
+    JobSystem jobSystem(JobSystem::getDefaultThreadCount(), [](unsigned int index)
+    {
+        AllocationCounter::bindSlot(index);
+    });
+
+    cv::Mat image1;
+    cv::Mat image2;
+    JobCounter decoded;
+    jobSystem.submit([&image1] { image1 = decodeImage("etc/brick.jpg"); }, &decoded);
+    jobSystem.submit([&image2] { image2 = decodeImage("etc/tree.jpg"); }, &decoded);
+    jobSystem.wait(decoded);
+
+    unsigned int texture1 = loadTexture(image1);
+    unsigned int texture2 = loadTexture(image2);
+
+    ourShader.use();
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
+
+    glEnable(GL_DEPTH_TEST);
+
+    // our cubes: entities in a grid in front of the camera, alternating between two materials
+    World world;
+    unsigned int program = ourShader.getShaderProgramHandle();
+
+    for (int x = 0; x != cubesPerSide; ++x)
+    {
+        for (int y = 0; y != cubesPerSide; ++y)
+        {
+            for (int z = 0; z != cubesPerSide; ++z)
+            {
+                Transform transform {};
+                transform.position = glm::vec3(2.0f * x - cubesPerSide, 2.0f * y - cubesPerSide, -2.0f * z - 5.0f);
+                transform.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+                transform.scale = glm::vec3(1.0f);
+
+                // alternate the two texture sets, so sorting has state to group
+                bool swapped = (x + y + z) % 2;
+                Material material {program, {swapped ? texture2 : texture1, swapped ? texture1 : texture2}};
+
+                world.create(transform, Mesh {VAO, 0, 36}, material, Bounds {glm::vec3(0.0f), 0.87f});
+            }
+        }
+    }
+
+    // the cube as an occluder for the software rasterizer
+    const glm::vec3 occluderCorners[8] = {
+            {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f}, {0.5f, 0.5f, -0.5f},
+            {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}
+    };
+    const unsigned int occluderIndices[36] = {
+            0, 1, 3, 0, 3, 2,   4, 7, 5, 4, 6, 7,   0, 2, 6, 0, 6, 4,
+            1, 5, 7, 1, 7, 3,   0, 4, 5, 0, 5, 1,   2, 3, 7, 2, 7, 6
+    };
+
+    // hierarchical-Z: the scene is drawn into an offscreen target whose depth feeds the pyramid, then shown
+    auto hiz = std::make_unique<HiZBuffer>();
+    unsigned int sceneFramebuffer = 0;
+    unsigned int sceneColor = 0;
+    unsigned int sceneDepth = 0;
+    int sceneWidth = 0;
+    int sceneHeight = 0;
+    DepthPyramid fetchedPyramid;
+
+    // readbacks travel from the render thread to the simulation thread through this slot
+    std::mutex hizMutex;
+    DepthPyramid hizPyramid;
+    glm::mat4 hizView(1.0f);
+    glm::mat4 hizProjection(1.0f);
+    bool hizFresh = false;
+
+    auto resizeSceneTarget = [&](int width, int height)
+    {
+        if (!sceneFramebuffer)
+        {
+            glGenFramebuffers(1, &sceneFramebuffer);
+            glGenRenderbuffers(1, &sceneColor);
+            glGenTextures(1, &sceneDepth);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, sceneFramebuffer);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, sceneColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, sceneColor);
+
+        glBindTexture(GL_TEXTURE_2D, sceneDepth);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, sceneDepth, 0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            std::cout << std::unitbuf
+                      << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                      << "\n[ERROR] " << "Scene framebuffer is not complete!"
+                      << std::nounitbuf << std::endl;
+
+            std::abort();
+        }
+
+        sceneWidth = width;
+        sceneHeight = height;
+    };
+
+    // heap allocations per thread once the first frames have sized every buffer and arena
+    const unsigned long long warmUpFrames = 60;
+    unsigned long long renderFrames = 0;
+    std::size_t renderAllocations = 0;
+    std::size_t simulationAllocations = 0;
+    std::size_t workerAllocations = 0;
+
+    // 6. the render thread takes over the context; it only ever sees frame packets
+    RenderThread<FramePacket> renderThread(window, [&](const FramePacket & packet)
+    {
+        std::size_t allocations = AllocationCounter::getThreadCount();
+
+        if (packet.buildHiZ && (packet.width != sceneWidth || packet.height != sceneHeight))
+        {
+            resizeSceneTarget(packet.width, packet.height);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, packet.buildHiZ ? sceneFramebuffer : 0);
+        glViewport(0, 0, packet.width, packet.height);
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        packet.commands.execute([&](unsigned int program)
+        {
+            uniforms.projection.set(packet.projection);
+            uniforms.view.set(packet.view);
+        });
+
+        if (packet.buildHiZ)
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, sceneFramebuffer);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            glBlitFramebuffer(0, 0, packet.width, packet.height, 0, 0, packet.width, packet.height,
+                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+            hiz->build(hizShader, hizUniforms, sceneDepth, packet.width, packet.height, packet.view,
+                       packet.projection);
+            glViewport(0, 0, packet.width, packet.height);
+
+            glm::mat4 view;
+            glm::mat4 projection;
+
+            if (hiz->fetch(fetchedPyramid, view, projection))
+            {
+                std::lock_guard<std::mutex> lock(hizMutex);
+                hizPyramid.swap(fetchedPyramid);
+                hizView = view;
+                hizProjection = projection;
+                hizFresh = true;
+            }
+        }
+
+        if (++renderFrames > warmUpFrames)
+        {
+            renderAllocations += AllocationCounter::getThreadCount() - allocations;
+        }
+    }, pacing);
+
+    renderThread.start();
+
+    // one command list per job thread, merged into the packet every frame
+    std::vector<CommandList> recordLists(jobSystem.getThreadCount());
+    int modelLocation = uniforms.model.getLocation();
+    unsigned long long simulationFrames = 0;
+
+    // the pyramid culling tests against, with the matrices its depth was made with
+    DepthPyramid cullPyramid;
+    glm::mat4 cullView(1.0f);
+    glm::mat4 cullProjection(1.0f);
+    SoftwareOccluder softwareOccluder;
+    const std::size_t occluderCount = 64;
+    std::vector<std::pair<float, const glm::mat4 *>> occluders;
+
+    // culling statistics, summed over all frames and shown in the title
+    std::atomic<unsigned long long> frustumCulled {0};
+    std::atomic<unsigned long long> occlusionCulled {0};
+    std::atomic<unsigned long long> drawn {0};
+    double titleTime = 0.0;
+
+    // 7. simulation loop on the main thread
+    while (!glfwWindowShouldClose(window))
+    {
+        std::size_t allocations = AllocationCounter::getThreadCount();
+        std::size_t jobAllocations = AllocationCounter::getSlotCount(1, jobSystem.getThreadCount());
+
+        // per-frame time logic
+        auto currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // process input
+        glfwPollEvents();
+        processInput(window);
+
+        // simulate
+        if (simulateMs)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(simulateMs));
+        }
+
+        // nothing to draw while the window is minimized
+        if (framebufferWidth <= 0 || framebufferHeight <= 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            continue;
+        }
+
+        // produce this frame's packet
+        FramePacket & packet = renderThread.beginFrame();
+        packet.width = framebufferWidth;
+        packet.height = framebufferHeight;
+        float aspect = static_cast<float>(packet.width) / static_cast<float>(std::max(packet.height, 1));
+        packet.projection = glm::perspective(glm::radians(camera.Zoom), aspect, 0.1f, 100.0f);
+        packet.view = camera.GetViewMatrix();
+        packet.arenas.resize(jobSystem.getThreadCount());
+        packet.arenas.reset();
+        packet.buildHiZ = occlusion == OcclusionMode::Gpu;
+
+        // transform system: every cube spins in place
+        world.parallelEachChunk<Transform>(jobSystem, [&](std::size_t count, const Entity * entities,
+                                                          Transform * transforms)
+        {
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                Transform & transform = transforms[i];
+                float angle = 20.0f * static_cast<float>(entities[i].index % 18) + 50.0f * currentFrame;
+                transform.rotation = glm::angleAxis(glm::radians(angle), glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f)));
+
+                transform.world = glm::translate(glm::mat4(1.0f), transform.position) *
+                                  glm::mat4_cast(transform.rotation);
+                transform.world = glm::scale(transform.world, transform.scale);
+            }
+        });
+
+        // occluders: the newest GPU pyramid, or the nearest cubes rasterized now
+        if (occlusion == OcclusionMode::Gpu)
+        {
+            std::lock_guard<std::mutex> lock(hizMutex);
+
+            if (hizFresh)
+            {
+                cullPyramid.swap(hizPyramid);
+                cullView = hizView;
+                cullProjection = hizProjection;
+                hizFresh = false;
+            }
+        }
+        else if (occlusion == OcclusionMode::Cpu)
+        {
+            Frustum frustum(packet.projection * packet.view);
+            occluders.clear();
+
+            world.each<Transform, Bounds>([&](Entity, Transform & transform, Bounds & bounds)
+            {
+                glm::vec3 center = glm::vec3(transform.world * glm::vec4(bounds.center, 1.0f));
+
+                if (frustum.intersectsSphere(center, bounds.radius))
+                {
+                    occluders.emplace_back(glm::length(center - camera.Position), &transform.world);
+                }
+            });
+
+            std::size_t count = std::min(occluders.size(), occluderCount);
+            std::nth_element(occluders.begin(), occluders.begin() + count, occluders.end());
+
+            int occluderWidth = 256;
+            int occluderHeight = std::max(1, occluderWidth * packet.height / std::max(packet.width, 1));
+            softwareOccluder.begin(occluderWidth, occluderHeight, packet.projection * packet.view);
+
+            for (std::size_t i = 0; i != count; ++i)
+            {
+                softwareOccluder.drawTriangles(*occluders[i].second, occluderCorners, 8, occluderIndices, 36);
+            }
+
+            cullView = packet.view;
+            cullProjection = packet.projection;
+        }
+
+        const DepthPyramid * occluderDepth = occlusion == OcclusionMode::Gpu ? &cullPyramid :
+                                             occlusion == OcclusionMode::Cpu ? &softwareOccluder.end() : nullptr;
+        Frustum frustum(packet.projection * packet.view);
+
+        // render system: records the draws of each chunk into the list of the thread that runs it
+        for (CommandList & commands : recordLists)
+        {
+            commands.clear();
+        }
+
+        world.parallelEachChunk<Transform, Mesh, Material, Bounds>(
+                jobSystem,
+                [&](std::size_t count, const Entity *, Transform * transforms, Mesh * meshes, Material * materials,
+                    Bounds * bounds)
+                {
+                    unsigned int thread = jobSystem.getThreadIndex();
+                    CommandList & commands = recordLists[thread];
+
+                    // the world matrices change next frame, while the render thread may still read this packet
+                    auto models = packet.arenas[thread].allocate<glm::mat4>(count);
+                    unsigned long long chunkFrustumCulled = 0;
+                    unsigned long long chunkOcclusionCulled = 0;
+                    unsigned long long chunkDrawn = 0;
+
+                    for (std::size_t i = 0; i != count; ++i)
+                    {
+                        glm::vec3 worldCenter = glm::vec3(transforms[i].world * glm::vec4(bounds[i].center, 1.0f));
+
+                        if (!frustum.intersectsSphere(worldCenter, bounds[i].radius))
+                        {
+                            ++chunkFrustumCulled;
+                            continue;
+                        }
+
+                        if (occluderDepth &&
+                            occluderDepth->isOccluded(cullView, cullProjection, worldCenter, bounds[i].radius))
+                        {
+                            ++chunkOcclusionCulled;
+                            continue;
+                        }
+
+                        models[chunkDrawn] = transforms[i].world;
+
+                        // depth of the bounding sphere's front, sorts front to back
+                        glm::vec4 center = packet.view * glm::vec4(worldCenter, 1.0f);
+                        float depth = (-center.z - bounds[i].radius) / 100.0f;
+
+                        commands.draw(materials[i].program, meshes[i].vertexArray,
+                                      materials[i].textures[0], materials[i].textures[1],
+                                      modelLocation, &models[chunkDrawn], meshes[i].first, meshes[i].count, depth);
+                        ++chunkDrawn;
+                    }
+
+                    frustumCulled += chunkFrustumCulled;
+                    occlusionCulled += chunkOcclusionCulled;
+                    drawn += chunkDrawn;
+                });
+
+        packet.commands.clear();
+
+        for (const CommandList & commands : recordLists)
+        {
+            packet.commands.append(commands);
+        }
+
+        packet.commands.sort();
+
+        if (++simulationFrames > warmUpFrames)
+        {
+            simulationAllocations += AllocationCounter::getThreadCount() - allocations;
+            workerAllocations += AllocationCounter::getSlotCount(1, jobSystem.getThreadCount()) - jobAllocations;
+        }
+
+        renderThread.submit();
+
+        if (currentFrame - titleTime > 0.5)
+        {
+            titleTime = currentFrame;
+            char title[128];
+            std::snprintf(title, sizeof(title), "OpenGLDemo - per frame: %llu drawn, %llu occluded, %llu outside",
+                          drawn / simulationFrames, occlusionCulled / simulationFrames,
+                          frustumCulled / simulationFrames);
+            glfwSetWindowTitle(window, title);
+        }
+    }
+
+    renderThread.stop();
+
+    RenderThread<FramePacket>::Stats stats = renderThread.getStats();
+    std::cout << "[INFO] submitted " << stats.submitted << ", rendered " << stats.rendered
+              << ", dropped " << stats.dropped << ", last latency " << stats.lastLatency * 1000.0 << " ms"
+              << std::endl;
+    std::cout << "[INFO] heap allocations after " << warmUpFrames << " warm-up frames: render thread "
+              << renderAllocations << ", simulation thread " << simulationAllocations << ", job workers "
+              << workerAllocations << std::endl;
+    std::cout << "[INFO] cubes per frame: " << drawn / std::max(simulationFrames, 1ull) << " drawn, "
+              << occlusionCulled / std::max(simulationFrames, 1ull) << " occlusion culled, "
+              << frustumCulled / std::max(simulationFrames, 1ull) << " frustum culled" << std::endl;
+
+    // 8. de-allocate all resources once they've outlived their purpose:
+    hiz.reset();
+    glDeleteFramebuffers(1, &sceneFramebuffer);
+    glDeleteRenderbuffers(1, &sceneColor);
+    glDeleteTextures(1, &sceneDepth);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteTextures(1, &texture1);
+    glDeleteTextures(1, &texture2);
+    shaderCache.clear();
+    glfwTerminate();
+
+    return 0;
+}
+
+
+cv::Mat decodeImage(const char * path)
+{
+    cv::Mat image = cv::imread(path);
+
+    if (image.empty())
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "cv::imread failed!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    return image;
+}
+
+
+unsigned int loadTexture(const cv::Mat & image)
+{
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // create texture and generate mipmaps
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.cols, image.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, image.data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    return texture;
+}
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height)
+{
+    // no context on this thread any more: the render thread applies the size via the next packet
+    framebufferWidth = width;
+    framebufferHeight = height;
+}
+
+
+void processInput(GLFWwindow * window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    {
+        glfwSetWindowShouldClose(window, true);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+    }
+}
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods)
+{
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    {
+        mousePressed = true;
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+    {
+        mousePressed = false;
+    }
+}
+
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;  // reversed since y-coordinates go from bottom to top
+
+    lastX = xpos;
+    lastY = ypos;
+
+    if (mousePressed)
+    {
+        camera.ProcessMouseMovement(xoffset, yoffset);
+    }
+}
+
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,375 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <opencv2/opencv.hpp>
+
+#include "learnopengl/camera.h"
+#include "learnopengl/mesh.h"
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_preprocessor.h"
+#include "uniforms/LodUniforms.h"
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height);
+
+void key_callback(GLFWwindow * window, int key, int scancode, int action, int mods);
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos);
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods);
+
+void processInput(GLFWwindow * window);
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset);
+
+unsigned int loadTexture(const char * path);
+
+
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
+
+// camera
+QuaternionCamera camera(glm::vec3(0.0f, 1.0f, 6.0f));
+
+// mouse
+bool mousePressed = false;
+bool firstMouse = true;
+float lastX = SCR_WIDTH / 2.0f;
+float lastY = SCR_HEIGHT / 2.0f;
+
+// timing
+float deltaTime = 0.0f;     // time between current frame and last frame
+float lastFrame = 0.0f;
+
+// level of detail, toggled with L; the error budget in pixels is changed with +/-
+bool lodEnabled = true;
+float maxPixelError = 1.0f;
+
+
+// usage: 13_lod [mesh.obj]
+// The LOD chain is built at import and stored next to the mesh as <mesh.obj>.lodmesh; later runs load it directly
+// until the OBJ is modified, which rebuilds it.
+// Without a mesh a UV sphere is generated.
+int main(int argc, char * argv[])
+{
+    // 1. OpenGL content by GLFW
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
+
+    if (!window)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to create GLFW window!"
+                  << std::nounitbuf << std::endl;
+        glfwTerminate();
+        std::abort();
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // 2. load OpenGL functions by GLAD
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to initialize GLAD!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // 3. build and compile our shader program
+    ShaderCache shaderCache;
+    Shader ourShader = shaderCache.get("src/shader/09_vert_shader.glsl", "src/shader/07_frag_shader.glsl");
+    LodUniforms uniforms(ourShader.getShaderProgramHandle());
+
+    // 4. import the mesh and its LOD chain
+    MeshData meshData;
+
+    if (argc > 1)
+    {
+        std::string cachePath = std::string(argv[1]) + ".lodmesh";
+
+        // a cache older than the OBJ is stale; without the OBJ, the cache is all there is
+        std::error_code objError;
+        std::error_code cacheError;
+        auto objTime = std::filesystem::last_write_time(argv[1], objError);
+        auto cacheTime = std::filesystem::last_write_time(cachePath, cacheError);
+        bool cacheCurrent = !cacheError && (objError || cacheTime >= objTime);
+
+        if (!cacheCurrent || !MeshData::load(cachePath.c_str(), meshData))
+        {
+            if (!MeshData::importObj(argv[1], meshData))
+            {
+                std::cout << std::unitbuf
+                          << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                          << "\n[ERROR] " << "Failed to import " << argv[1]
+                          << std::nounitbuf << std::endl;
+
+                std::abort();
+            }
+
+            meshData.buildLods();
+
+            if (!meshData.save(cachePath.c_str()))
+            {
+                std::cout << "[WARNING] Failed to write " << cachePath << ", the LODs are rebuilt on the next run"
+                          << std::endl;
+            }
+        }
+    }
+    else
+    {
+        meshData = MeshData::sphere();
+        meshData.buildLods();
+    }
+
+    for (const MeshLod & lod : meshData.lods)
+    {
+        std::cout << "[INFO] LOD " << &lod - meshData.lods.data() << ": " << lod.indexCount / 3
+                  << " triangles, error " << lod.error << std::endl;
+    }
+
+    // held by pointer so its buffers are deleted before glfwTerminate
+    auto mesh = std::make_unique<LodMesh>(meshData);
+
+    // 5. texture
+    unsigned int texture1 = loadTexture("etc/brick.jpg");
+    unsigned int texture2 = loadTexture("etc/tree.jpg");
+
+    ourShader.use();
+    uniforms.texture1.set({0});
+    uniforms.texture2.set({1});
+
+    // 6. render loop
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+
+    // a field of objects reaching far from the camera
+    const int fieldSize = 25;
+    const float spacing = 4.0f;
+    double titleTime = 0.0;
+
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        auto currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // process input
+        processInput(window);
+
+        // background
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture1);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2);
+
+        float aspect = static_cast<float>(framebufferWidth) / static_cast<float>(std::max(framebufferHeight, 1));
+        uniforms.projection.set(camera.GetProjectionMatrix(aspect, 0.1f, 200.0f));
+        uniforms.view.set(camera.GetViewMatrix());
+
+        // pixels per world unit at distance 1: zooming in makes far objects need finer levels
+        float projectionScale = camera.GetProjectionScale(static_cast<float>(framebufferHeight));
+
+        mesh->bind();
+        unsigned long long triangles = 0;
+        unsigned long long fullTriangles = 0;
+
+        for (int x = 0; x != fieldSize; ++x)
+        {
+            for (int z = 0; z != fieldSize; ++z)
+            {
+                glm::vec3 position(spacing * (x - fieldSize / 2), 0.0f, -spacing * z);
+                uniforms.model.set(glm::translate(glm::mat4(1.0f), position));
+
+                int level = lodEnabled ?
+                            mesh->selectLod(glm::length(position - camera.Position), projectionScale, 1.0f,
+                                            maxPixelError) : 0;
+                mesh->draw(level);
+
+                triangles += mesh->getTriangleCount(level);
+                fullTriangles += mesh->getTriangleCount(0);
+            }
+        }
+
+        if (currentFrame - titleTime > 0.5)
+        {
+            titleTime = currentFrame;
+            char title[128];
+            std::snprintf(title, sizeof(title), "OpenGLDemo - LOD %s, %.1f px: %llu of %llu triangles",
+                          lodEnabled ? "on" : "off", maxPixelError, triangles, fullTriangles);
+            glfwSetWindowTitle(window, title);
+        }
+
+        // check and call events and swap the buffers
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // 7. de-allocate all resources once they've outlived their purpose:
+    mesh.reset();
+    glDeleteTextures(1, &texture1);
+    glDeleteTextures(1, &texture2);
+    shaderCache.clear();
+    glfwTerminate();
+
+    return 0;
+}
+
+
+unsigned int loadTexture(const char * path)
+{
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // load image, create texture and generate mipmaps
+    cv::Mat image = cv::imread(path);
+
+    if (image.empty())
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "cv::imread failed!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.cols, image.rows, 0, GL_RGB, GL_UNSIGNED_BYTE, image.data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    return texture;
+}
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height)
+{
+    framebufferWidth = width;
+    framebufferHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+
+void key_callback(GLFWwindow * window, int key, int scancode, int action, int mods)
+{
+    if (action != GLFW_PRESS)
+    {
+        return;
+    }
+
+    if (key == GLFW_KEY_L)
+    {
+        lodEnabled = !lodEnabled;
+    }
+    else if (key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_ADD)
+    {
+        maxPixelError *= 2.0f;
+    }
+    else if (key == GLFW_KEY_MINUS || key == GLFW_KEY_KP_SUBTRACT)
+    {
+        maxPixelError = std::max(0.25f, maxPixelError * 0.5f);
+    }
+}
+
+
+void processInput(GLFWwindow * window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    {
+        glfwSetWindowShouldClose(window, true);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+    }
+}
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods)
+{
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    {
+        mousePressed = true;
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+    {
+        mousePressed = false;
+    }
+}
+
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;  // reversed since y-coordinates go from bottom to top
+
+    lastX = xpos;
+    lastY = ypos;
+
+    if (mousePressed)
+    {
+        camera.ProcessMouseMovement(xoffset, yoffset);
+    }
+}
+
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
\ No newline at end of file
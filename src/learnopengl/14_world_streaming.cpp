@@ -0,0 +1,304 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "learnopengl/camera.h"
+#include "learnopengl/gpu_memory.h"
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_preprocessor.h"
+#include "learnopengl/world_streamer.h"
+#include "uniforms/WorldStreamingUniforms.h"
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height);
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos);
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods);
+
+void processInput(GLFWwindow * window);
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset);
+
+
+const unsigned int SCR_WIDTH = 800;
+const unsigned int SCR_HEIGHT = 600;
+
+int framebufferWidth = SCR_WIDTH;
+int framebufferHeight = SCR_HEIGHT;
+
+// camera
+Camera camera(glm::vec3(0.0f, 20.0f, 0.0f));
+
+// mouse
+bool mousePressed = false;
+bool firstMouse = true;
+float lastX = SCR_WIDTH / 2.0f;
+float lastY = SCR_HEIGHT / 2.0f;
+
+// timing
+float deltaTime = 0.0f;     // time between current frame and last frame
+float lastFrame = 0.0f;
+
+
+// usage: 14_world_streaming [image] [streamer budget in MB] [GPU budget in MB] [minimum free video memory in MB]
+// -- the world file "<image>.world" is baked on first run
+// Chunks stream in around the camera as it flies over the terrain; the title shows what is resident and loading.
+// When all tracked GL objects exceed the GPU budget, or the driver reports less free video memory than the minimum,
+// the streamer downscales and evicts chunk textures.
+int main(int argc, char * argv[])
+{
+    std::string imagePath = argc > 1 ? argv[1] : "etc/brick.jpg";
+    std::string worldPath = imagePath + ".world";
+
+    WorldStreamerSettings settings;
+    GpuMemoryBudgetSettings budgetSettings;
+
+    if (argc > 2)
+    {
+        settings.memoryBudget = static_cast<std::size_t>(std::atof(argv[2]) * (1 << 20));
+    }
+
+    if (argc > 3)
+    {
+        budgetSettings.trackedBudget = static_cast<std::size_t>(std::atof(argv[3]) * (1 << 20));
+    }
+
+    if (argc > 4)
+    {
+        budgetSettings.minimumAvailable = static_cast<std::size_t>(std::atof(argv[4]) * (1 << 20));
+    }
+
+    // 0. offline baking (only once; afterwards chunks are read from the world file as needed)
+
+    if (!std::ifstream(worldPath))
+    {
+        WorldStreamer::bake(worldPath.c_str(), imagePath.c_str());
+    }
+
+    // 1. OpenGL content by GLFW
+
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    GLFWwindow * window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "OpenGLDemo", nullptr, nullptr);
+
+    if (!window)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to create GLFW window!"
+                  << std::nounitbuf << std::endl;
+        glfwTerminate();
+        std::abort();
+    }
+
+    glfwMakeContextCurrent(window);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // 2. load OpenGL functions by GLAD
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to initialize GLAD!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // 3. build and compile our shader program
+    ShaderCache shaderCache;
+    Shader ourShader = shaderCache.get("src/shader/09_vert_shader.glsl", "src/shader/14_frag_shader.glsl");
+    WorldStreamingUniforms uniforms(ourShader.getShaderProgramHandle());
+
+    ourShader.use();
+    uniforms.chunkTexture.set({0});
+
+    // 4. the streamer, held by pointer so its GL objects are deleted before glfwTerminate
+    auto streamer = std::make_unique<WorldStreamer>(worldPath.c_str(), settings);
+
+    camera.Position += streamer->getCenter();
+    camera.MovementSpeed = 20.0f;
+
+    GpuMemoryBudget gpuBudget(budgetSettings);
+    gpuBudget.addConsumer([&](std::size_t bytes) { return streamer->reclaim(bytes); },
+                          [&](std::size_t bytes) { streamer->grant(bytes); });
+
+    // 5. render loop
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
+
+    double titleTime = 0.0;
+
+    while (!glfwWindowShouldClose(window))
+    {
+        // per-frame time logic
+        auto currentFrame = static_cast<float>(glfwGetTime());
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+
+        // process input
+        processInput(window);
+
+        // stream around where the camera is now
+        streamer->update(camera.Position, camera.Front);
+        gpuBudget.update();
+
+        // background
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        float aspect = static_cast<float>(framebufferWidth) / static_cast<float>(std::max(framebufferHeight, 1));
+        const glm::mat4 & projection = camera.GetProjectionMatrix(aspect, 0.5f, settings.unloadRadius + 64.0f);
+        glm::mat4 view = camera.GetViewMatrix();
+        uniforms.projection.set(projection);
+        uniforms.view.set(view);
+
+        // only the resident chunks in view are drawn
+        Frustum frustum(projection * view);
+        int drawn = 0;
+
+        glActiveTexture(GL_TEXTURE0);
+
+        streamer->forEachResident([&](const WorldStreamer::ResidentChunk & chunk)
+        {
+            if (!frustum.intersectsSphere(chunk.center, chunk.radius))
+            {
+                return;
+            }
+
+            uniforms.model.set(glm::translate(glm::mat4(1.0f), chunk.origin));
+            glBindTexture(GL_TEXTURE_2D, chunk.texture);
+            glBindVertexArray(chunk.vertexArray);
+            glDrawElements(GL_TRIANGLES, chunk.indexCount, GL_UNSIGNED_INT, nullptr);
+            ++drawn;
+        });
+
+        glBindVertexArray(0);
+
+        if (currentFrame - titleTime > 0.5)
+        {
+            titleTime = currentFrame;
+            WorldStreamer::Stats stats = streamer->getStats();
+            const GpuMemoryInfo & driver = gpuBudget.getDriverInfo();
+            char title[512];
+            std::snprintf(title, sizeof(title),
+                          "OpenGLDemo - %d drawn, %zu resident, %zu loading, %zu queued, %.1f + %.1f pooled of %.1f MB,"
+                          " %llu evicted, %llu uploads, %llu resources reused, %llu allocated, textures / %d"
+                          " (%llu downscaled), GL %.1f of %.1f MB, %s %.0f MB free",
+                          drawn, stats.resident, stats.loading, stats.queued,
+                          stats.residentBytes / 1048576.0, stats.pooledBytes / 1048576.0,
+                          stats.memoryBudget / 1048576.0, stats.evictions, stats.uploads, stats.poolReuses,
+                          stats.poolAllocations, 1 << stats.textureReduction, stats.downscales,
+                          GlResourceTracker::instance().getTotalBytes() / 1048576.0,
+                          budgetSettings.trackedBudget / 1048576.0, driver.source ? driver.source : "driver",
+                          driver.availableBytes / 1048576.0);
+            glfwSetWindowTitle(window, title);
+        }
+
+        // check and call events and swap the buffers
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+    }
+
+    // 6. de-allocate all resources once they've outlived their purpose:
+    gpuBudget.printReport(std::cout, true);
+    streamer.reset();
+    shaderCache.clear();
+    GlResourceTracker::instance().reportLeaks();
+    glfwTerminate();
+
+    return 0;
+}
+
+
+void framebuffer_size_callback(GLFWwindow * window, int width, int height)
+{
+    framebufferWidth = width;
+    framebufferHeight = height;
+    glViewport(0, 0, width, height);
+}
+
+
+void processInput(GLFWwindow * window)
+{
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    {
+        glfwSetWindowShouldClose(window, true);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(FORWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(BACKWARD, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(LEFT, deltaTime);
+    }
+
+    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    {
+        camera.ProcessKeyboard(RIGHT, deltaTime);
+    }
+}
+
+
+void mouse_button_callback(GLFWwindow * window, int button, int action, int mods)
+{
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+    {
+        mousePressed = true;
+    }
+
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+    {
+        mousePressed = false;
+    }
+}
+
+
+void mouse_callback(GLFWwindow * window, double xpos, double ypos)
+{
+    if (firstMouse)
+    {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    float xoffset = xpos - lastX;
+    float yoffset = lastY - ypos;  // reversed since y-coordinates go from bottom to top
+
+    lastX = xpos;
+    lastY = ypos;
+
+    if (mousePressed)
+    {
+        camera.ProcessMouseMovement(xoffset, yoffset);
+    }
+}
+
+
+void scroll_callback(GLFWwindow * window, double xoffset, double yoffset)
+{
+    camera.ProcessMouseScroll(yoffset);
+}
@@ -0,0 +1,40 @@
+#version 330 core
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+// the scene, rendered into the lower left part of the texture
+uniform sampler2D source;
+uniform vec2 uvScale;       // rendered size / texture size
+uniform float sharpness;    // 0 for plain bilinear
+
+
+void main()
+{
+    // keep the bilinear footprint inside the rendered part
+    vec2 texelSize = 1.0 / vec2(textureSize(source, 0));
+    vec2 uvMin = 0.5 * texelSize;
+    vec2 uvMax = uvScale - 0.5 * texelSize;
+    vec2 uv = clamp(TexCoord * uvScale, uvMin, uvMax);
+    vec3 center = texture(source, uv).rgb;
+
+    if (sharpness <= 0.0)
+    {
+        FragColor = vec4(center, 1.0);
+        return;
+    }
+
+    // unsharp mask on the source texel cross, limited to the neighbourhood's range so edges do not ring; the taps
+    // stay inside the rendered part too, or the border would blend in stale texels of a larger earlier frame
+    vec3 left = texture(source, clamp(uv - vec2(texelSize.x, 0.0), uvMin, uvMax)).rgb;
+    vec3 right = texture(source, clamp(uv + vec2(texelSize.x, 0.0), uvMin, uvMax)).rgb;
+    vec3 down = texture(source, clamp(uv - vec2(0.0, texelSize.y), uvMin, uvMax)).rgb;
+    vec3 up = texture(source, clamp(uv + vec2(0.0, texelSize.y), uvMin, uvMax)).rgb;
+
+    vec3 low = min(center, min(min(left, right), min(down, up)));
+    vec3 high = max(center, max(max(left, right), max(down, up)));
+    vec3 sharpened = center + sharpness * (4.0 * center - left - right - down - up) * 0.25;
+
+    FragColor = vec4(clamp(sharpened, low, high), 1.0);
+}
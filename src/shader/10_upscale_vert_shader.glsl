@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec2 TexCoord;
+
+
+// one triangle covering the viewport, drawn without vertex buffers
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,46 @@
+#version 330 core
+
+#include "include/virtual_texture.glsl"
+
+in vec2 TexCoord;
+
+#ifdef VT_FEEDBACK
+
+layout (location = 0) out uvec4 FeedbackColor;
+
+uniform float vtFeedbackBias;  // corrects the mip selection for the reduced feedback resolution
+
+#else
+
+out vec4 FragColor;
+
+uniform vec4 vtPhysicalLayout;  // (tile size, border, page stride, physical atlas size) in texels
+
+// physical page atlas and the per-page indirection table
+uniform sampler2D vtPhysical;
+uniform sampler2D vtIndirection;
+
+#endif
+
+
+void main()
+{
+    vec2 uv = TexCoord * vtImageExtent;
+
+#ifdef VT_FEEDBACK
+    // page coordinates of the requested level, written out as (x, y, level, valid)
+    float level = vtLevel(uv, vtFeedbackBias);
+    vec2 page = floor(uv * vtVirtualPages / exp2(level));
+    FeedbackColor = uvec4(uvec2(page), uint(level), 1u);
+#else
+    // (slot x, slot y, resident level) of the finest resident page covering uv
+    vec3 entry = floor(textureLod(vtIndirection, uv, vtLevel(uv, 0.0)).rgb * 255.0 + 0.5);
+
+    // position inside that page, then inside the atlas, skipping the border ring
+    vec2 inPage = fract(uv * vtVirtualPages / exp2(entry.b));
+    vec2 physical = (entry.rg * vtPhysicalLayout.z + vtPhysicalLayout.y + inPage * vtPhysicalLayout.x)
+                    / vtPhysicalLayout.w;
+
+    FragColor = textureLod(vtPhysical, physical, 0.0);
+#endif
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+layout (location = 0) out float FarthestDepth;
+
+// the depth buffer, or the previous pyramid level as the only level visible
+uniform sampler2D source;
+
+
+void main()
+{
+    // the 2x2 source texels under this texel; odd sizes repeat the last row or column
+    ivec2 last = textureSize(source, 0) - 1;
+    ivec2 texel = ivec2(gl_FragCoord.xy) * 2;
+
+    float d0 = texelFetch(source, min(texel, last), 0).r;
+    float d1 = texelFetch(source, min(texel + ivec2(1, 0), last), 0).r;
+    float d2 = texelFetch(source, min(texel + ivec2(0, 1), last), 0).r;
+    float d3 = texelFetch(source, min(texel + ivec2(1, 1), last), 0).r;
+
+    FarthestDepth = max(max(d0, d1), max(d2, d3));
+}
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+uniform sampler2D chunkTexture;
+
+
+void main()
+{
+    FragColor = texture(chunkTexture, TexCoord);
+}
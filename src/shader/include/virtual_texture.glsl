@@ -0,0 +1,16 @@
+#pragma once
+
+// virtual texture layout, see VirtualTexture::setUniforms
+uniform float vtVirtualPages;
+uniform float vtVirtualSize;
+uniform float vtMaxLevel;
+uniform vec2 vtImageExtent;
+
+
+// mip level of the virtual texture needed at uv, from the screen-space derivatives of its texel position
+float vtLevel(vec2 uv, float bias)
+{
+    vec2 texel = uv * vtVirtualSize;
+    float lod = log2(max(length(dFdx(texel)), length(dFdy(texel)))) + bias;
+    return clamp(floor(lod), 0.0, vtMaxLevel);
+}
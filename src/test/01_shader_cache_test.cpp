@@ -0,0 +1,153 @@
+// 01_shader_cache_test: ShaderCache answers a repeated request without preprocessing it again.
+//
+// usage: 01_shader_cache_test <scratch directory>
+//
+// Writes a shader program with an #include into the scratch directory and requests it from a ShaderCache, then
+// requests it again through a different spelling of the paths, with the defines in another order, and once more after
+// deleting its files: all three must return the same program, and only the first may preprocess. A different define
+// set must preprocess and compile a program of its own. Needs a GPU and a display; without them it exits with 77,
+// which ctest reports as skipped.
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "learnopengl/shader.h"
+#include "learnopengl/shader_preprocessor.h"
+
+
+// the SKIP_RETURN_CODE of the test
+const int SKIP_EXIT_CODE = 77;
+
+const char * vertShaderCode = R"(#version 330 core
+#include "common.glsl"
+layout (location = 0) in vec3 aPos;
+void main()
+{
+    gl_Position = vec4(aPos * SCALE, 1.0);
+}
+)";
+
+const char * fragShaderCode = R"(#version 330 core
+out vec4 FragColor;
+void main()
+{
+#ifdef RED
+    FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+#else
+    FragColor = vec4(1.0);
+#endif
+}
+)";
+
+const char * commonCode = R"(const float SCALE = 0.5;
+)";
+
+
+void writeFile(const std::string & path, const char * code)
+{
+    std::ofstream fout {path, std::ofstream::out};
+    fout << code;
+
+    if (!fout)
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to write " << path
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+}
+
+
+bool check(bool condition, const char * what)
+{
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << what << std::endl;
+    return condition;
+}
+
+
+int main(int argc, char * argv[])
+{
+    std::string directory = argc > 1 ? argv[1] : ".";
+    directory += "/shader_cache_test";
+
+    // 1. a hidden window for the context
+
+    if (!glfwInit())
+    {
+        std::cout << "[SKIP] GLFW could not be initialized" << std::endl;
+        return SKIP_EXIT_CODE;
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow * window = glfwCreateWindow(64, 64, "ShaderCacheTest", nullptr, nullptr);
+
+    if (!window)
+    {
+        std::cout << "[SKIP] no OpenGL 3.3 context available" << std::endl;
+        glfwTerminate();
+        return SKIP_EXIT_CODE;
+    }
+
+    glfwMakeContextCurrent(window);
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+        std::cout << std::unitbuf
+                  << "[ERROR] " << __FILE__ << ':' << __LINE__ << ' ' << __PRETTY_FUNCTION__
+                  << "\n[ERROR] " << "Failed to initialize GLAD!"
+                  << std::nounitbuf << std::endl;
+
+        std::abort();
+    }
+
+    // 2. the program's files
+
+    std::filesystem::create_directories(directory);
+    writeFile(directory + "/vert.glsl", vertShaderCode);
+    writeFile(directory + "/frag.glsl", fragShaderCode);
+    writeFile(directory + "/common.glsl", commonCode);
+
+    // 3. the requests
+
+    ShaderCache cache;
+    bool passed = true;
+
+    unsigned int first = cache.get(directory + "/vert.glsl", directory + "/frag.glsl", {"RED", "UNUSED"})
+            .getShaderProgramHandle();
+    passed &= check(cache.getPreprocessCount() == 1 && cache.getProgramCount() == 1, "a new request is compiled");
+
+    unsigned int respelled = cache.get(directory + "/../shader_cache_test/./vert.glsl",
+                                       directory + "//frag.glsl", {"UNUSED", "RED", "RED"}).getShaderProgramHandle();
+    passed &= check(respelled == first && cache.getPreprocessCount() == 1 && cache.getHitCount() == 1,
+                    "the same request through other paths and define orders is not preprocessed");
+
+    unsigned int other = cache.get(directory + "/vert.glsl", directory + "/frag.glsl").getShaderProgramHandle();
+    passed &= check(other != first && cache.getPreprocessCount() == 2 && cache.getProgramCount() == 2,
+                    "another define set is a program of its own");
+
+    // a hit that read the files would abort now
+    std::filesystem::remove_all(directory);
+
+    unsigned int cached = cache.get(directory + "/vert.glsl", directory + "/frag.glsl", {"RED", "UNUSED"})
+            .getShaderProgramHandle();
+    passed &= check(cached == first && cache.getPreprocessCount() == 2 && cache.getHitCount() == 2,
+                    "a hit reads no file");
+
+    // 4. de-allocate all resources once they've outlived their purpose:
+    cache.clear();
+    glfwTerminate();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
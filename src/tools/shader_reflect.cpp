@@ -0,0 +1,407 @@
+// shader_reflect: build-time generator of typed uniform structs.
+//
+// usage: shader_reflect <output.h> <StructName> <vert.glsl> <frag.glsl> [-DNAME[=VALUE] ...] [-I<dir> ...]
+//
+// Both stages are preprocessed exactly as at runtime (includes, the given defines, #ifdef/#ifndef/#else/#endif),
+// then every default-block uniform declaration is collected into a struct of Uniform<T> members
+// (learnopengl/uniforms.h). Code then names uniforms as C++ members, so a misspelt uniform no longer compiles.
+// #if and #elif are rejected: their expressions are not evaluated, and guessing would generate wrong members.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "learnopengl/shader_preprocessor.h"
+
+
+struct UniformDecl
+{
+    std::string type;
+    std::string name;
+    int arraySize;  // 0 for non-arrays
+};
+
+
+const std::map<std::string, std::string> kTypeMap = {
+        {"bool",  "bool"},
+        {"int",   "int"},
+        {"uint",  "unsigned int"},
+        {"float", "float"},
+        {"vec2",  "glm::vec2"},
+        {"vec3",  "glm::vec3"},
+        {"vec4",  "glm::vec4"},
+        {"ivec2", "glm::ivec2"},
+        {"ivec3", "glm::ivec3"},
+        {"ivec4", "glm::ivec4"},
+        {"mat2",  "glm::mat2"},
+        {"mat3",  "glm::mat3"},
+        {"mat4",  "glm::mat4"},
+};
+
+
+[[noreturn]] void fail(const std::string & message)
+{
+    std::cerr << "[ERROR] shader_reflect: " << message << std::endl;
+    std::exit(1);
+}
+
+
+std::string cppType(const std::string & glslType)
+{
+    if (glslType.find("sampler") != std::string::npos)
+    {
+        return "Sampler";
+    }
+
+    auto it = kTypeMap.find(glslType);
+
+    if (it == kTypeMap.end())
+    {
+        fail("unsupported uniform type " + glslType);
+    }
+
+    return it->second;
+}
+
+
+// keeps only the lines enabled by #ifdef/#ifndef/#else/#endif under the defines seen so far
+std::string evaluateConditionals(const std::string & code)
+{
+    std::istringstream sin(code);
+    std::ostringstream sout;
+    std::set<std::string> defined;
+    std::vector<std::pair<bool, bool>> stack;  // (this branch active, parent active)
+    std::string line;
+
+    auto active = [&stack]
+    {
+        return stack.empty() || (stack.back().first && stack.back().second);
+    };
+
+    while (std::getline(sin, line))
+    {
+        std::istringstream words(line);
+        std::string directive;
+        std::string name;
+        words >> directive >> name;
+
+        if (directive == "#ifdef" || directive == "#ifndef")
+        {
+            bool isDefined = defined.count(name) != 0;
+            stack.emplace_back(directive == "#ifdef" ? isDefined : !isDefined, active());
+        }
+        else if (directive == "#if" || directive == "#elif")
+        {
+            fail(directive + " is not supported, use #ifdef/#ifndef/#else: " + line);
+        }
+        else if (directive == "#else")
+        {
+            if (stack.empty())
+            {
+                fail("#else without #if");
+            }
+
+            stack.back().first = !stack.back().first;
+        }
+        else if (directive == "#endif")
+        {
+            if (stack.empty())
+            {
+                fail("#endif without #if");
+            }
+
+            stack.pop_back();
+        }
+        else if (active())
+        {
+            if (directive == "#define")
+            {
+                defined.insert(name);
+            }
+            else if (directive == "#undef")
+            {
+                defined.erase(name);
+            }
+
+            sout << line << '\n';
+        }
+    }
+
+    return sout.str();
+}
+
+
+std::string stripComments(const std::string & code)
+{
+    std::string result;
+
+    for (std::size_t i = 0; i < code.size(); ++i)
+    {
+        if (code.compare(i, 2, "//") == 0)
+        {
+            i = code.find('\n', i);
+
+            if (i == std::string::npos)
+            {
+                break;
+            }
+
+            result += '\n';
+        }
+        else if (code.compare(i, 2, "/*") == 0)
+        {
+            i = code.find("*/", i + 2);
+
+            if (i == std::string::npos)
+            {
+                break;
+            }
+
+            ++i;
+            result += ' ';
+        }
+        else
+        {
+            result += code[i];
+        }
+    }
+
+    return result;
+}
+
+
+// collects "uniform [precision] type name[N], name2 ...;" statements at global scope, skipping uniform blocks
+std::vector<UniformDecl> parseUniforms(const std::string & code)
+{
+    std::vector<UniformDecl> uniforms;
+    std::string statement;
+    int depth = 0;
+
+    for (char c : code)
+    {
+        if (c == '{')
+        {
+            ++depth;
+        }
+        else if (c == '}')
+        {
+            --depth;
+            statement.clear();
+        }
+        else if (depth == 0 && c == ';')
+        {
+            std::string text;
+
+            // drop preprocessor lines and layout qualifiers from the statement
+            std::istringstream lines(statement);
+            std::string line;
+
+            while (std::getline(lines, line))
+            {
+                if (line.find('#') == std::string::npos)
+                {
+                    text += line + ' ';
+                }
+            }
+
+            for (std::size_t layout = text.find("layout"); layout != std::string::npos; layout = text.find("layout"))
+            {
+                text.erase(layout, text.find(')', layout) + 1 - layout);
+            }
+
+            std::istringstream words(text);
+            std::string word;
+            words >> word;
+
+            if (word == "uniform")
+            {
+                std::string type;
+                words >> type;
+
+                if (type == "lowp" || type == "mediump" || type == "highp")
+                {
+                    words >> type;
+                }
+
+                std::string rest;
+                std::getline(words, rest);
+                std::istringstream declarators(rest);
+                std::string declarator;
+
+                while (std::getline(declarators, declarator, ','))
+                {
+                    std::size_t equal = declarator.find('=');
+                    declarator = declarator.substr(0, equal);
+
+                    UniformDecl decl {type, "", 0};
+                    std::size_t bracket = declarator.find('[');
+
+                    if (bracket != std::string::npos)
+                    {
+                        decl.arraySize = std::stoi(declarator.substr(bracket + 1));
+                        declarator = declarator.substr(0, bracket);
+                    }
+
+                    std::istringstream nameStream(declarator);
+                    nameStream >> decl.name;
+
+                    if (!decl.name.empty())
+                    {
+                        uniforms.push_back(decl);
+                    }
+                }
+            }
+
+            statement.clear();
+        }
+        else if (depth == 0)
+        {
+            statement += c;
+        }
+    }
+
+    return uniforms;
+}
+
+
+int main(int argc, char * argv[])
+{
+    if (argc < 5)
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " <output.h> <StructName> <vert.glsl> <frag.glsl> [-DNAME[=VALUE] ...] [-I<dir> ...]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::string outputPath = argv[1];
+    std::string structName = argv[2];
+    std::vector<std::string> stages = {argv[3], argv[4]};
+    std::vector<std::string> defines;
+    std::vector<std::string> includeDirectories;
+
+    for (int i = 5; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if (arg.compare(0, 2, "-D") == 0)
+        {
+            defines.push_back(arg.substr(2));
+        }
+        else if (arg.compare(0, 2, "-I") == 0)
+        {
+            includeDirectories.push_back(arg.substr(2));
+        }
+        else
+        {
+            fail("unknown argument " + arg);
+        }
+    }
+
+    ShaderPreprocessor preprocessor(includeDirectories);
+    std::vector<UniformDecl> uniforms;
+
+    for (const std::string & stage : stages)
+    {
+        std::string code = stripComments(evaluateConditionals(preprocessor.process(stage, defines).code));
+
+        for (const UniformDecl & decl : parseUniforms(code))
+        {
+            auto same = std::find_if(uniforms.begin(), uniforms.end(),
+                                     [&decl](const UniformDecl & u) { return u.name == decl.name; });
+
+            if (same == uniforms.end())
+            {
+                uniforms.push_back(decl);
+            }
+            else if (same->type != decl.type || same->arraySize != decl.arraySize)
+            {
+                fail("uniform " + decl.name + " is declared with different types across stages");
+            }
+        }
+    }
+
+    std::ostringstream header;
+    std::string guard = "LEARNOPENGL_UNIFORMS_" + structName + "_H";
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+
+    header << "// Generated by shader_reflect from " << stages[0] << " and " << stages[1];
+
+    for (const std::string & define : defines)
+    {
+        header << " -D" << define;
+    }
+
+    header << ". Do not edit.\n"
+           << "#ifndef " << guard << '\n'
+           << "#define " << guard << "\n\n"
+           << "#include <array>\n\n"
+           << "#include \"learnopengl/uniforms.h\"\n\n\n"
+           << "struct " << structName << "\n"
+           << "{\n"
+           << "    explicit " << structName << "(unsigned int program)";
+
+    for (std::size_t i = 0; i != uniforms.size(); ++i)
+    {
+        const UniformDecl & u = uniforms[i];
+        header << (i == 0 ? " :\n" : ",\n") << "            " << u.name;
+
+        if (u.arraySize == 0)
+        {
+            header << "(program, \"" << u.name << "\")";
+        }
+        else
+        {
+            header << " {{";
+
+            for (int e = 0; e != u.arraySize; ++e)
+            {
+                header << (e == 0 ? "" : ", ") << "{program, \"" << u.name << '[' << e << "]\"}";
+            }
+
+            header << "}}";
+        }
+    }
+
+    header << "\n    {\n    }\n\n";
+
+    for (const UniformDecl & u : uniforms)
+    {
+        if (u.arraySize == 0)
+        {
+            header << "    Uniform<" << cppType(u.type) << "> " << u.name << ";\n";
+        }
+        else
+        {
+            header << "    std::array<Uniform<" << cppType(u.type) << ">, " << u.arraySize << "> " << u.name << ";\n";
+        }
+    }
+
+    header << "};\n\n#endif // " << guard << '\n';
+
+    // leave the file untouched when nothing changed, so dependents are not rebuilt
+    std::string existing;
+
+    if (Shader::readFile(outputPath.c_str(), existing) && existing == header.str())
+    {
+        return 0;
+    }
+
+    std::ofstream fout {outputPath, std::ofstream::out};
+
+    if (!fout)
+    {
+        fail("cannot write " + outputPath);
+    }
+
+    fout << header.str();
+
+    return 0;
+}